@@ -0,0 +1,228 @@
+// Converts a picture into an image for the LED matrix of the clock, see src/images.h:
+//
+//	go run main.go -name synthwave synthwave.png >> ../../src/images.h
+//
+// The picture must have the size of the matrix. The pixels are written row by row as RGB565, which is
+// the color format of matrix.Color(), so drawImage() does not have to convert anything.
+//
+// An animated GIF becomes an animation, see src/animation.h:
+//
+//	go run main.go -name heart -width 8 -height 8 heart.gif >> ../../src/animation.h
+//
+// The colors of all frames form the palette (at most 256 colors). Every frame is a list of runs over the
+// pixels: either n pixels of one palette color or n pixels which stay as in the previous frame.
+package main
+
+import (
+	"flag"
+	"fmt"
+	"image"
+	"image/draw"
+	"image/gif"
+	_ "image/jpeg"
+	_ "image/png"
+	"os"
+	"path/filepath"
+	"strings"
+)
+
+const valuesPerLine = 16
+
+func main() {
+	name := flag.String("name", "", "name of the image in images.h (default: the file name)")
+	width := flag.Int("width", 32, "width of the matrix")
+	height := flag.Int("height", 8, "height of the matrix")
+	flag.Usage = func() {
+		fmt.Fprintln(os.Stderr, "usage: golang_img_to_neomatrix [-name name] [-width 32] [-height 8] picture.png")
+		flag.PrintDefaults()
+	}
+	flag.Parse()
+	if flag.NArg() != 1 {
+		flag.Usage()
+		os.Exit(2)
+	}
+
+	path := flag.Arg(0)
+	if *name == "" {
+		*name = strings.TrimSuffix(filepath.Base(path), filepath.Ext(path))
+	}
+
+	file, err := os.Open(path)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, err)
+		os.Exit(1)
+	}
+	defer file.Close()
+
+	var frames []image.Image
+	var durations []int
+	if strings.EqualFold(filepath.Ext(path), ".gif") {
+		frames, durations, err = decodeGIF(file)
+	} else {
+		var picture image.Image
+		picture, _, err = image.Decode(file)
+		frames = []image.Image{picture}
+	}
+	if err != nil {
+		fmt.Fprintln(os.Stderr, path+":", err)
+		os.Exit(1)
+	}
+
+	for _, frame := range frames {
+		bounds := frame.Bounds()
+		if bounds.Dx() != *width || bounds.Dy() != *height {
+			fmt.Fprintf(os.Stderr, "%s: the picture is %dx%d, the matrix %dx%d\n", path, bounds.Dx(), bounds.Dy(), *width, *height)
+			os.Exit(1)
+		}
+	}
+
+	if len(frames) == 1 {
+		writeImage(*name, *width, *height, colors(frames[0]))
+		return
+	}
+	if err := writeAnimation(*name, *width, *height, frames, durations); err != nil {
+		fmt.Fprintln(os.Stderr, path+":", err)
+		os.Exit(1)
+	}
+}
+
+func writeImage(name string, width, height int, pixels []uint16) {
+	fmt.Printf("constexpr uint16_t %sPixels[%d * %d] = {\n", name, height, width)
+	writeValues(pixels, "0x%04X")
+	fmt.Println("};")
+	fmt.Printf("const image %s = { %d, %d, %sPixels };\n", name, width, height, name)
+}
+
+func writeAnimation(name string, width, height int, frames []image.Image, durations []int) error {
+	var palette []uint16
+	paletteIndex := map[uint16]int{}
+	var data, offsets []uint16
+	var previous []int
+
+	for _, frame := range frames {
+		// palette indices of the pixels
+		var indices []int
+		for _, color := range colors(frame) {
+			index, ok := paletteIndex[color]
+			if !ok {
+				if len(palette) == 256 {
+					return fmt.Errorf("more than 256 colors")
+				}
+				index = len(palette)
+				paletteIndex[color] = index
+				palette = append(palette, color)
+			}
+			indices = append(indices, index)
+		}
+
+		offsets = append(offsets, uint16(len(data)))
+		data = append(data, encodeFrame(indices, previous)...)
+		previous = indices
+	}
+	if len(data) > 0xFFFF {
+		return fmt.Errorf("the frames need more than 64 KB")
+	}
+	duration := durations[0]
+	if duration <= 0 {
+		duration = 100
+	}
+
+	fmt.Printf("constexpr uint16_t %sPalette[%d] = {\n", name, len(palette))
+	writeValues(palette, "0x%04X")
+	fmt.Println("};")
+	fmt.Printf("constexpr uint16_t %sFrames[%d] = {\n", name, len(offsets))
+	writeValues(offsets, "%d")
+	fmt.Println("};")
+	fmt.Printf("constexpr uint8_t %sData[%d] = {\n", name, len(data))
+	writeValues(data, "0x%02X")
+	fmt.Println("};")
+	fmt.Printf("const animation %s = { %d, %d, %d, %d, %sPalette, %sFrames, %sData };\n",
+		name, width, height, len(frames), duration, name, name, name)
+	return nil
+}
+
+// runs of at most 128 pixels: 0x00 + n - 1 followed by the palette index = n pixels of that color,
+// 0x80 + n - 1 = n pixels stay as they are. The first frame has no pixels to keep.
+func encodeFrame(indices, previous []int) []uint16 {
+	var data []uint16
+	for i := 0; i < len(indices); {
+		n := 1
+		if previous != nil && indices[i] == previous[i] {
+			for i+n < len(indices) && n < 128 && indices[i+n] == previous[i+n] {
+				n++
+			}
+			data = append(data, uint16(0x80+n-1))
+		} else {
+			for i+n < len(indices) && n < 128 && indices[i+n] == indices[i] && (previous == nil || indices[i+n] != previous[i+n]) {
+				n++
+			}
+			data = append(data, uint16(n-1), uint16(indices[i]))
+		}
+		i += n
+	}
+	return data
+}
+
+// the frames of a GIF only contain the part which changes, so we draw them onto a canvas
+func decodeGIF(file *os.File) ([]image.Image, []int, error) {
+	animated, err := gif.DecodeAll(file)
+	if err != nil {
+		return nil, nil, err
+	}
+	bounds := image.Rect(0, 0, animated.Config.Width, animated.Config.Height)
+	canvas := image.NewRGBA(bounds)
+	var frames []image.Image
+	var durations []int
+	for i, frame := range animated.Image {
+		before := image.NewRGBA(bounds)
+		draw.Draw(before, bounds, canvas, image.Point{}, draw.Src)
+		draw.Draw(canvas, frame.Bounds(), frame, frame.Bounds().Min, draw.Over)
+
+		result := image.NewRGBA(bounds)
+		draw.Draw(result, bounds, canvas, image.Point{}, draw.Src)
+		frames = append(frames, result)
+		durations = append(durations, animated.Delay[i]*10)
+
+		switch animated.Disposal[i] {
+		case gif.DisposalBackground:
+			draw.Draw(canvas, frame.Bounds(), image.Transparent, image.Point{}, draw.Src)
+		case gif.DisposalPrevious:
+			canvas = before
+		}
+	}
+	return frames, durations, nil
+}
+
+// RGB565 pixels row by row
+func colors(picture image.Image) []uint16 {
+	var pixels []uint16
+	bounds := picture.Bounds()
+	for y := bounds.Min.Y; y < bounds.Max.Y; y++ {
+		for x := bounds.Min.X; x < bounds.Max.X; x++ {
+			r, g, b, _ := picture.At(x, y).RGBA()
+			pixels = append(pixels, rgb565(uint8(r>>8), uint8(g>>8), uint8(b>>8)))
+		}
+	}
+	return pixels
+}
+
+func writeValues(values []uint16, format string) {
+	for i := 0; i < len(values); i += valuesPerLine {
+		end := i + valuesPerLine
+		separator := ","
+		if end >= len(values) {
+			end = len(values)
+			separator = ""
+		}
+		var line []string
+		for _, value := range values[i:end] {
+			line = append(line, fmt.Sprintf(format, value))
+		}
+		fmt.Printf("  %s%s\n", strings.Join(line, ", "), separator)
+	}
+}
+
+// same as matrix.Color(r, g, b)
+func rgb565(r, g, b uint8) uint16 {
+	return uint16(r&0xF8)<<8 | uint16(g&0xFC)<<3 | uint16(b)>>3
+}
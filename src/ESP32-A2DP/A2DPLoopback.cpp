@@ -0,0 +1,124 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include "A2DPLoopback.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+A2DPLoopback::A2DPLoopback(a2dp_loopback_source_cb_t source_callback, a2dp_loopback_sink_cb_t sink_callback, a2dp_loopback_config_t config) {
+    this->source_callback = source_callback;
+    this->sink_callback = sink_callback;
+    this->config = config;
+}
+
+/// xorshift: we want reproducible runs
+uint32_t A2DPLoopback::next_random() {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+float A2DPLoopback::next_random_float() {
+    return (next_random() >> 8) / 16777216.0f;
+}
+
+a2dp_loopback_stats_t A2DPLoopback::run(uint32_t duration_ms) {
+    a2dp_loopback_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    random_state = config.seed == 0 ? 1 : config.seed;
+
+    double rate = config.sample_rate;
+    double sink_rate = rate * (1.0 + config.skew_ppm / 1000000.0);
+    double capacity = config.sink_buffer_ms * rate / 1000.0;
+    double prefill = config.prefill_ms * rate / 1000.0;
+    double end_time = duration_ms / 1000.0;
+    int32_t max_frames = config.frames_per_packet + config.frames_variation;
+    std::vector<uint8_t> packet(max_frames * 4);
+
+    double send_time = 0;
+    double last_arrival = 0;
+    double last_time = 0;
+    double level = 0;        // frames in the sink buffer
+    bool is_playing = false;
+    bool is_lossy = false;
+    double latency_sum = 0;
+    uint32_t latency_count = 0;
+
+    while (send_time < end_time) {
+        int32_t frames = config.frames_per_packet;
+        if (config.frames_variation > 0) {
+            frames += (int32_t)(next_random() % (2 * config.frames_variation + 1)) - config.frames_variation;
+        }
+        frames = std::max(1, frames);
+        int32_t len = source_callback(packet.data(), frames * 4);
+        if (len <= 0) {
+            // the source has no data: the packet schedule goes on with silence
+            memset(packet.data(), 0, frames * 4);
+        } else {
+            frames = std::min(frames, len / 4);
+        }
+        stats.packets++;
+
+        // burst loss
+        is_lossy = is_lossy ? next_random_float() >= config.loss_leave : next_random_float() < config.loss_enter;
+        double packet_send_time = send_time;
+        send_time += frames / rate;
+        if (is_lossy) {
+            stats.packets_lost++;
+            continue;
+        }
+
+        // the link keeps the order of the packets
+        double arrival = packet_send_time + (config.latency_ms + next_random_float() * config.jitter_ms) / 1000.0;
+        arrival = std::max(arrival, last_arrival);
+        last_arrival = arrival;
+
+        // playback of the sink until the arrival
+        if (is_playing) {
+            double played = (arrival - last_time) * sink_rate;
+            if (played > level) {
+                stats.underruns++;
+                stats.underrun_frames += played - level;
+                level = 0;
+                is_playing = false;
+            } else {
+                level -= played;
+            }
+        }
+        last_time = arrival;
+
+        sink_callback(packet.data(), frames * 4);
+        stats.frames_delivered += frames;
+        if (is_playing) {
+            // the first frame of the packet is played after the buffered frames
+            double latency = (arrival - packet_send_time) + level / sink_rate;
+            latency_sum += latency;
+            latency_count++;
+            stats.latency_max_ms = std::max(stats.latency_max_ms, (float)(latency * 1000.0));
+        }
+        level += frames;
+        if (level > capacity) {
+            stats.overflows++;
+            stats.overflow_frames += level - capacity;
+            level = capacity;
+        }
+        if (!is_playing && level >= prefill) {
+            is_playing = true;
+        }
+    }
+    stats.latency_avg_ms = latency_count == 0 ? 0 : latency_sum * 1000.0 / latency_count;
+    return stats;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include <stdint.h>
+
+/// provides the frames of a packet like the data callback of the source (ccall_bt_app_a2d_data_cb): returns the bytes
+typedef int32_t (*a2dp_loopback_source_cb_t)(uint8_t *data, int32_t len);
+/// receives the frames of a packet like the data callback of the sink (ccall_audio_data_callback)
+typedef void (*a2dp_loopback_sink_cb_t)(const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Settings of the simulated link of A2DPLoopback
+ */
+struct a2dp_loopback_config_t {
+    uint32_t sample_rate = 44100;
+    // packet schedule: SBC packets of frames_per_packet +/- frames_variation frames
+    int32_t frames_per_packet = 640;
+    int32_t frames_variation = 128;
+    // link: a packet arrives after latency_ms + [0, jitter_ms]
+    uint32_t latency_ms = 20;
+    uint32_t jitter_ms = 15;
+    // burst loss (Gilbert-Elliott): probabilities per packet to enter and to leave the lossy state
+    float loss_enter = 0.002;
+    float loss_leave = 0.3;
+    // the sink clock is faster (> 0) or slower (< 0) than the source clock
+    float skew_ppm = 100;
+    // buffer of the sink: playback starts when prefill_ms are available
+    uint32_t sink_buffer_ms = 200;
+    uint32_t prefill_ms = 60;
+    uint32_t seed = 1;
+};
+
+/**
+ * @brief Result of A2DPLoopback::run()
+ */
+struct a2dp_loopback_stats_t {
+    uint32_t packets;
+    uint32_t packets_lost;
+    uint32_t frames_delivered;
+    uint32_t underruns;
+    uint32_t underrun_frames;
+    uint32_t overflows;
+    uint32_t overflow_frames;
+    float latency_avg_ms;
+    float latency_max_ms;
+    /// number of audible glitches: lost packets, underruns and overflows
+    uint32_t glitches() {
+        return packets_lost + underruns + overflows;
+    }
+};
+
+/**
+ * @brief Simulated A2DP transport which connects the data callback of a source with the data callback of a sink
+ * without any radio: the data is requested from the source on a simulated SBC packet schedule and delivered to the
+ * sink with configurable packet size variation, jitter, burst loss and clock skew.
+ *
+ * The simulation runs in virtual time as fast as the callbacks allow, so that different buffering
+ * strategies can be compared by the reported latency and glitches. It only depends on the two callbacks, so it
+ * also runs on a host. On the ESP32 the source can be ccall_bt_app_a2d_data_cb. ccall_audio_data_callback can only
+ * be the sink if the BluetoothA2DPSink does not write to I2S (set_stream_reader(callback, false)), because
+ * i2s_write() blocks for the real playback time.
+ * @copyright Apache License Version 2
+ */
+class A2DPLoopback {
+  public:
+    A2DPLoopback(a2dp_loopback_source_cb_t source_callback, a2dp_loopback_sink_cb_t sink_callback,
+                 a2dp_loopback_config_t config = a2dp_loopback_config_t());
+    /// simulates the indicated time of streaming
+    a2dp_loopback_stats_t run(uint32_t duration_ms);
+
+  protected:
+    a2dp_loopback_config_t config;
+    a2dp_loopback_source_cb_t source_callback;
+    a2dp_loopback_sink_cb_t sink_callback;
+    uint32_t random_state;
+
+    uint32_t next_random();
+    float next_random_float();
+};
@@ -14,6 +14,7 @@
 // Copyright 2015-2016 Espressif Systems (Shanghai) PTE LTD
 
 #include "BluetoothA2DPSink.h"
+#include "esp_system.h" // esp_random
 
 // to support static callback functions
 BluetoothA2DPSink* actual_bluetooth_a2dp_sink;
@@ -137,6 +138,7 @@ void BluetoothA2DPSink::start(const char* name)
     init_nvs();
     if (is_auto_reconnect){
         get_last_connection();
+        get_reconnect_history();
     }
 
     // setup i2s
@@ -664,19 +666,11 @@ void BluetoothA2DPSink::handle_connection_state(uint16_t event, void *p_param){
             i2s_zero_dma_buffer(i2s_port);
         }
         
-        if (is_reconnect(a2d->conn_stat.disc_rsn) && is_auto_reconnect && has_last_connection()) {
-            if ( has_last_connection()  && connection_rety_count < try_reconnect_max_count ){
-                ESP_LOGI(BT_AV_TAG,"Connection try number: %d", connection_rety_count);
-                connect_to_last_device();
-                // when we lost the connection we do allow any others to connect after 2 trials
-                if (connection_rety_count==2) set_scan_mode_connectable(true);
-
-            } else {
-                if ( has_last_connection() && a2d->conn_stat.disc_rsn == ESP_A2D_DISC_RSN_NORMAL ){
-                    clean_last_connection();
-                }
-                set_scan_mode_connectable(true);
-            }
+        if (is_reconnect_active) {
+            // the last reconnect attempt has failed
+            schedule_reconnect();
+        } else if (is_reconnect(a2d->conn_stat.disc_rsn) && is_auto_reconnect && !reconnect_history.empty()) {
+            start_reconnect();
         } else {
             set_scan_mode_connectable(true);   
         }
@@ -699,7 +693,14 @@ void BluetoothA2DPSink::handle_connection_state(uint16_t event, void *p_param){
         }                
         
         set_scan_mode_connectable(false);   
-        connection_rety_count = 0;
+        if (is_reconnect_active) {
+            reconnect_stats.last_latency_ms = millis() - reconnect_start_ms;
+            reconnect_stats.max_latency_ms = std::max(reconnect_stats.max_latency_ms, reconnect_stats.last_latency_ms);
+            reconnect_stats.last_attempts = connection_rety_count;
+            reconnect_stats.reconnects++;
+            ESP_LOGI(BT_AV_TAG, "reconnected after %u ms and %d tries", reconnect_stats.last_latency_ms, connection_rety_count);
+            stop_reconnect();
+        }
         if (is_i2s_output) {
             ESP_LOGI(BT_AV_TAG,"i2s_start");
             if (i2s_start(i2s_port)!=ESP_OK){
@@ -709,6 +710,7 @@ void BluetoothA2DPSink::handle_connection_state(uint16_t event, void *p_param){
         // record current connection
         if (is_auto_reconnect && is_valid) {
             set_last_connection(a2d->conn_stat.remote_bda);
+            update_reconnect_history(a2d->conn_stat.remote_bda);
         }
 #ifdef CURRENT_ESP_IDF
         // ask for the remote name
@@ -716,10 +718,176 @@ void BluetoothA2DPSink::handle_connection_state(uint16_t event, void *p_param){
 #endif                 
     } else if (a2d->conn_stat.state == ESP_A2D_CONNECTION_STATE_CONNECTING){
         ESP_LOGI(BT_AV_TAG, "ESP_A2D_CONNECTION_STATE_CONNECTING");
-        connection_rety_count++;
     } 
 }
 
+void BluetoothA2DPSink::get_reconnect_history(){
+    ESP_LOGD(BT_AV_TAG, "%s", __func__);
+    reconnect_history.clear();
+
+    nvs_handle my_handle;
+    esp_err_t err = nvs_open("connected_bda", NVS_READWRITE, &my_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(BT_AV_TAG,"NVS OPEN ERROR");
+    } else {
+        bt_source_history_t history[A2DP_RECONNECT_HISTORY_MAX];
+        size_t size = sizeof(history);
+        err = nvs_get_blob(my_handle, reconnect_history_nvs_name(), history, &size);
+        if (err == ESP_OK) {
+            reconnect_history.assign(history, history + size / sizeof(bt_source_history_t));
+        } else if (err == ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGI(BT_AV_TAG, "nvs_blob does not exist");
+        } else {
+            ESP_LOGE(BT_AV_TAG, "nvs_get_blob failed");
+        }
+        nvs_close(my_handle);
+    }
+
+    // the last connection is always tried first
+    if (has_last_connection()){
+        bt_source_history_t source;
+        memcpy(source.bda, last_connection, ESP_BD_ADDR_LEN);
+        for (auto it = reconnect_history.begin(); it != reconnect_history.end(); ++it){
+            if (memcmp(it->bda, last_connection, ESP_BD_ADDR_LEN) == 0){
+                reconnect_history.erase(it);
+                break;
+            }
+        }
+        reconnect_history.insert(reconnect_history.begin(), source);
+        if (reconnect_history.size() > A2DP_RECONNECT_HISTORY_MAX){
+            reconnect_history.resize(A2DP_RECONNECT_HISTORY_MAX);
+        }
+    }
+    ESP_LOGI(BT_AV_TAG, "%d sources in reconnect history", (int) reconnect_history.size());
+}
+
+void BluetoothA2DPSink::set_reconnect_history(){
+    ESP_LOGD(BT_AV_TAG, "%s", __func__);
+    nvs_handle my_handle;
+    esp_err_t err = nvs_open("connected_bda", NVS_READWRITE, &my_handle);
+    if (err != ESP_OK){
+        ESP_LOGE(BT_AV_TAG, "NVS OPEN ERROR");
+        return;
+    }
+    if (reconnect_history.empty()){
+        err = nvs_erase_key(my_handle, reconnect_history_nvs_name());
+        if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;
+    } else {
+        err = nvs_set_blob(my_handle, reconnect_history_nvs_name(), reconnect_history.data(), reconnect_history.size() * sizeof(bt_source_history_t));
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(my_handle);
+    } else {
+        ESP_LOGE(BT_AV_TAG, "NVS WRITE ERROR");
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(BT_AV_TAG, "NVS COMMIT ERROR");
+    }
+    nvs_close(my_handle);
+}
+
+/// Moves the indicated source to the front of the history
+void BluetoothA2DPSink::update_reconnect_history(esp_bd_addr_t bda){
+    // same value, nothing to store
+    if (!reconnect_history.empty() && memcmp(reconnect_history[0].bda, bda, ESP_BD_ADDR_LEN) == 0){
+        return;
+    }
+    for (auto it = reconnect_history.begin(); it != reconnect_history.end(); ++it){
+        if (memcmp(it->bda, bda, ESP_BD_ADDR_LEN) == 0){
+            reconnect_history.erase(it);
+            break;
+        }
+    }
+    bt_source_history_t source;
+    memcpy(source.bda, bda, ESP_BD_ADDR_LEN);
+    reconnect_history.insert(reconnect_history.begin(), source);
+    if (reconnect_history.size() > A2DP_RECONNECT_HISTORY_MAX){
+        reconnect_history.resize(A2DP_RECONNECT_HISTORY_MAX);
+    }
+    set_reconnect_history();
+}
+
+void BluetoothA2DPSink::clean_reconnect_history(){
+    ESP_LOGD(BT_AV_TAG, "%s", __func__);
+    stop_reconnect();
+    reconnect_history.clear();
+    set_reconnect_history();
+}
+
+void BluetoothA2DPSink::clean_last_connection(){
+    stop_reconnect();
+    // the last source should not be reconnected after a disconnect
+    if (has_last_connection()){
+        for (auto it = reconnect_history.begin(); it != reconnect_history.end(); ++it){
+            if (memcmp(it->bda, last_connection, ESP_BD_ADDR_LEN) == 0){
+                reconnect_history.erase(it);
+                set_reconnect_history();
+                break;
+            }
+        }
+    }
+    BluetoothA2DPCommon::clean_last_connection();
+}
+
+void BluetoothA2DPSink::start_reconnect(){
+    ESP_LOGI(BT_AV_TAG, "%s with %d sources", __func__, (int) reconnect_history.size());
+    is_reconnect_active = true;
+    connection_rety_count = 0;
+    reconnect_start_ms = millis();
+    // we stay connectable between our pages, so the source which reaches us first wins
+    set_scan_mode_connectable(true);
+    schedule_reconnect();
+}
+
+/// Schedules the next reconnect attempt with an exponential backoff per round through the history
+void BluetoothA2DPSink::schedule_reconnect(){
+    if (reconnect_history.empty() || connection_rety_count >= try_reconnect_max_count){
+        ESP_LOGW(BT_AV_TAG, "reconnect failed after %d tries", connection_rety_count);
+        reconnect_stats.failures++;
+        stop_reconnect();
+        set_scan_mode_connectable(true);
+        return;
+    }
+
+    int round = connection_rety_count / reconnect_history.size();
+    uint32_t delay_ms = A2DP_RECONNECT_DELAY_MAX_MS;
+    if (round < 16) {
+        delay_ms = std::min((uint32_t) A2DP_RECONNECT_DELAY_MIN_MS << round, (uint32_t) A2DP_RECONNECT_DELAY_MAX_MS);
+    }
+    // add a jitter of up to 25% so that we do not page in lock step with the source
+    delay_ms += esp_random() % (delay_ms / 4 + 1);
+    ESP_LOGI(BT_AV_TAG, "next reconnect try in %u ms", delay_ms);
+
+    if (reconnect_timer == nullptr){
+        reconnect_timer = xTimerCreate("reconTmr", delay_ms / portTICK_RATE_MS, pdFALSE, NULL, ccall_app_reconnect_timer);
+    }
+    // starts the timer with the new period
+    if (xTimerChangePeriod(reconnect_timer, delay_ms / portTICK_RATE_MS, 10 / portTICK_RATE_MS) != pdPASS){
+        ESP_LOGE(BT_AV_TAG, "xTimerChangePeriod failed");
+    }
+}
+
+void BluetoothA2DPSink::stop_reconnect(){
+    is_reconnect_active = false;
+    if (reconnect_timer != nullptr){
+        xTimerStop(reconnect_timer, 10 / portTICK_RATE_MS);
+    }
+}
+
+/// Pages the next source of the history: called in the app task
+void BluetoothA2DPSink::reconnect_next(){
+    if (!is_reconnect_active || is_connected() || reconnect_history.empty()){
+        return;
+    }
+    bt_source_history_t &source = reconnect_history[connection_rety_count % reconnect_history.size()];
+    connection_rety_count++;
+    ESP_LOGI(BT_AV_TAG,"Connection try number %d: %s", connection_rety_count, to_str(source.bda));
+    if (esp_a2d_sink_connect(source.bda) != ESP_OK){
+        ESP_LOGE(BT_AV_TAG,"Failed connecting to device!");
+        schedule_reconnect();
+    }
+}
+
 uint16_t BluetoothA2DPSink::sample_rate(){
     return i2s_config.sample_rate;
 }
@@ -871,9 +1039,9 @@ void BluetoothA2DPSink::av_hdl_stack_evt(uint16_t event, void *p_param)
             if (esp_a2d_sink_init()!=ESP_OK){
                 ESP_LOGE(BT_AV_TAG,"esp_a2d_sink_init");            
             }
-            if (is_auto_reconnect && has_last_connection() ) {
-                ESP_LOGD(BT_AV_TAG, "connect_to_last_device");
-                connect_to_last_device();
+            if (is_auto_reconnect && !reconnect_history.empty()) {
+                ESP_LOGD(BT_AV_TAG, "start_reconnect");
+                start_reconnect();
             }
 
             /* set discoverable and connectable mode, wait to be connected */
@@ -882,6 +1050,10 @@ void BluetoothA2DPSink::av_hdl_stack_evt(uint16_t event, void *p_param)
             break;
         }
 
+        case BT_APP_EVT_RECONNECT:
+            reconnect_next();
+            break;
+
         default:
             ESP_LOGE(BT_AV_TAG, "%s unhandled evt %d", __func__, event);
             break;
@@ -1151,6 +1323,14 @@ void ccall_av_hdl_a2d_evt(uint16_t event, void *param){
     }
 }
 
+void ccall_app_reconnect_timer(TimerHandle_t timer){
+    ESP_LOGD(BT_AV_TAG, "%s", __func__);
+    // the reconnect is executed in the app task
+    if (actual_bluetooth_a2dp_sink) {
+        actual_bluetooth_a2dp_sink->app_work_dispatch(ccall_av_hdl_stack_evt, BT_APP_EVT_RECONNECT, NULL, 0);
+    }
+}
+
 //------------------------------------------------------------
 // ==> Methods which are only supported in new ESP Release 4
 
@@ -14,6 +14,7 @@
 // Copyright 2015-2016 Espressif Systems (Shanghai) PTE LTD
 
 #pragma once
+#include <vector>
 #include "BluetoothA2DPCommon.h"
 
 #ifdef __cplusplus
@@ -29,6 +30,7 @@ extern "C" {
 /* @brief event for handler "bt_av_hdl_stack_up */
 enum {
     BT_APP_EVT_STACK_UP = 0,
+    BT_APP_EVT_RECONNECT = 1,
 };
 
 extern "C" void ccall_app_a2d_callback(esp_a2d_cb_event_t event, esp_a2d_cb_param_t *param);
@@ -39,6 +41,7 @@ extern "C" void ccall_audio_data_callback(const uint8_t *data, uint32_t len);
 extern "C" void ccall_av_hdl_stack_evt(uint16_t event, void *p_param);
 extern "C" void ccall_av_hdl_a2d_evt(uint16_t event, void *p_param);
 extern "C" void ccall_av_hdl_avrc_evt(uint16_t event, void *p_param);
+extern "C" void ccall_app_reconnect_timer(TimerHandle_t timer);
 
 #ifdef CURRENT_ESP_IDF
 extern "C" void ccall_app_rc_tg_callback(esp_avrc_tg_cb_event_t event, esp_avrc_tg_cb_param_t *param);
@@ -48,6 +51,24 @@ extern "C" void ccall_av_hdl_avrc_tg_evt(uint16_t event, void *p_param);
 // defines the mechanism to confirm a pin request
 enum PinCodeRequest {Undefined, Confirm, Reply};
 
+/**
+ * @brief Source which has been connected to the sink
+ */
+struct bt_source_history_t {
+    esp_bd_addr_t bda;
+};
+
+/**
+ * @brief Statistics of the reconnect scheduler: latencies are in ms since the disconnect
+ */
+struct bt_reconnect_stats_t {
+    uint32_t last_latency_ms = 0;
+    uint32_t max_latency_ms = 0;
+    uint16_t last_attempts = 0;
+    uint16_t reconnects = 0;
+    uint16_t failures = 0;
+};
+
 /**
  * @brief A2DP Bluethooth Sink - We initialize and start the Bluetooth A2DP Sink. 
  * The example https://github.com/espressif/esp-idf/tree/master/examples/bluetooth/bluedroid/classic_bt/a2dp_sink
@@ -74,6 +95,8 @@ class BluetoothA2DPSink : public BluetoothA2DPCommon {
     friend void ccall_av_hdl_a2d_evt(uint16_t event, void *p_param);
     /// avrc event handler 
     friend void ccall_av_hdl_avrc_evt(uint16_t event, void *p_param);
+    /// reconnect scheduler
+    friend void ccall_app_reconnect_timer(TimerHandle_t timer);
 
 #ifdef CURRENT_ESP_IDF
 
@@ -207,6 +230,19 @@ class BluetoothA2DPSink : public BluetoothA2DPCommon {
         reconnect_on_normal_disconnect = afterNormalDisconnect;
         try_reconnect_max_count = count;
     }
+
+    /// Provides the statistics of the reconnect scheduler
+    virtual const bt_reconnect_stats_t& get_reconnect_stats(){
+        return reconnect_stats;
+    }
+
+    /// Provides the number of remembered sources
+    virtual int reconnect_history_count(){
+        return reconnect_history.size();
+    }
+
+    /// Forgets all remembered sources
+    virtual void clean_reconnect_history();
     
 
  #ifdef CURRENT_ESP_IDF
@@ -252,6 +288,12 @@ class BluetoothA2DPSink : public BluetoothA2DPCommon {
     bool swap_left_right = false;
     int try_reconnect_max_count = AUTOCONNECT_TRY_NUM;
     bool reconnect_on_normal_disconnect = false;
+    // reconnect scheduler: sources in LRU order
+    std::vector<bt_source_history_t> reconnect_history;
+    TimerHandle_t reconnect_timer = nullptr;
+    bool is_reconnect_active = false;
+    uint32_t reconnect_start_ms = 0;
+    bt_reconnect_stats_t reconnect_stats;
 
 #ifdef CURRENT_ESP_IDF
     esp_avrc_rn_evt_cap_mask_t s_avrc_peer_rn_cap;
@@ -276,6 +318,20 @@ class BluetoothA2DPSink : public BluetoothA2DPCommon {
         return "last_bda";
     }
 
+    virtual const char* reconnect_history_nvs_name() {
+        return "bda_history";
+    }
+
+    // reconnect scheduler
+    virtual void get_reconnect_history();
+    virtual void set_reconnect_history();
+    virtual void update_reconnect_history(esp_bd_addr_t bda);
+    virtual void clean_last_connection();
+    virtual void start_reconnect();
+    virtual void schedule_reconnect();
+    virtual void stop_reconnect();
+    virtual void reconnect_next();
+
     virtual bool is_reconnect(esp_a2d_disc_rsn_t type) {
         return reconnect_on_normal_disconnect || type==ESP_A2D_DISC_RSN_ABNORMAL;
     }
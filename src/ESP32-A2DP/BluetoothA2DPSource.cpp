@@ -14,6 +14,7 @@
 // Copyright 2015-2016 Espressif Systems (Shanghai) PTE LTD
 
 #include "BluetoothA2DPSource.h"
+#include <time.h>
 
 #define BT_APP_SIG_WORK_DISPATCH            (0x01)
 #define BT_APP_SIG_WORK_DISPATCH            (0x01)
@@ -68,6 +69,10 @@ extern "C" void ccall_a2d_app_heart_beat(void *arg) {
     if(self_BluetoothA2DPSource) self_BluetoothA2DPSource->a2d_app_heart_beat(arg);
 }
 
+extern "C" void ccall_bt_app_update_heart_beat(uint16_t event, void *param) {
+    if(self_BluetoothA2DPSource) self_BluetoothA2DPSource->update_heart_beat();
+}
+
 extern "C" void ccall_bt_app_a2d_cb(esp_a2d_cb_event_t event, esp_a2d_cb_param_t *param){
     if (self_BluetoothA2DPSource) self_BluetoothA2DPSource->bt_app_a2d_cb(event, param);
 }
@@ -82,10 +87,18 @@ extern "C" void ccall_bt_av_hdl_avrc_ct_evt(uint16_t event, void *param) {
 
 extern "C" int32_t ccall_bt_app_a2d_data_cb(uint8_t *data, int32_t len){
     //ESP_LOGD(BT_APP_TAG, "x%x - len: %d", __func__, len);
-    if (len <= 0 || data == NULL || self_BluetoothA2DPSource==NULL || self_BluetoothA2DPSource->data_stream_callback==NULL) {
+    if (len <= 0 || data == NULL || self_BluetoothA2DPSource==NULL) {
+        return 0;
+    }
+    int32_t result;
+    if (self_BluetoothA2DPSource->is_pcm_mode.load(std::memory_order_acquire)) {
+        // data has been provided with write_pcm
+        result = self_BluetoothA2DPSource->get_data_pcm(data, len);
+    } else if (self_BluetoothA2DPSource->data_stream_callback != NULL) {
+        result = (*(self_BluetoothA2DPSource->data_stream_callback))(data, len);
+    } else {
         return 0;
     }
-    int32_t result = (*(self_BluetoothA2DPSource->data_stream_callback))(data, len);
     // adapt volume
     if (result > 0 && self_BluetoothA2DPSource->is_volume_used){
         self_BluetoothA2DPSource->volume_control()->update_audio_data((Frame*)data, result/4, self_BluetoothA2DPSource->volume_value, false, true); 
@@ -132,6 +145,7 @@ BluetoothA2DPSource::BluetoothA2DPSource() {
 
 BluetoothA2DPSource::~BluetoothA2DPSource() {
     end();
+    delete pcm_buffer.load();
 }
 
 bool BluetoothA2DPSource::is_connected(){
@@ -172,6 +186,7 @@ void BluetoothA2DPSource::start_raw(std::vector<const char*> names, music_data_c
     ESP_LOGD(BT_APP_TAG, "%s, ", __func__);
     this->bt_names = names;
     this->data_stream_callback = callback;
+    setup_name_filter();
 
     // get last connection if not available
     if(!has_last_connection()){
@@ -192,6 +207,10 @@ void BluetoothA2DPSource::start_raw(std::vector<const char*> names, music_data_c
         ESP_ERROR_CHECK( ret );
     }
 
+    // load the known devices: they are paged before we start an inquiry (with auto reconnect) and every connection
+    // updates the table, which must not overwrite the entries in NVS
+    get_known_devices();
+
     if (reset_ble) {
         ESP_ERROR_CHECK(esp_bt_controller_mem_release(ESP_BT_MODE_BLE));
 
@@ -378,17 +397,18 @@ void BluetoothA2DPSource::filter_inquiry_scan_result(esp_bt_gap_cb_param_t *para
     uint8_t *eir = NULL;
     esp_bt_gap_dev_prop_t *p;
 
-    ESP_LOGI(BT_AV_TAG, "Scanned device: %s", to_str(param->disc_res.bda));
+    discovery_stats.devices_seen++;
+    ESP_LOGD(BT_AV_TAG, "Scanned device: %s", to_str(param->disc_res.bda));
     for (int i = 0; i < param->disc_res.num_prop; i++) {
         p = param->disc_res.prop + i;
         switch (p->type) {
         case ESP_BT_GAP_DEV_PROP_COD:
             cod = *(uint32_t *)(p->val);
-            ESP_LOGI(BT_AV_TAG, "--Class of Device: 0x%x", cod);
+            ESP_LOGD(BT_AV_TAG, "--Class of Device: 0x%x", cod);
             break;
         case ESP_BT_GAP_DEV_PROP_RSSI:
             rssi = *(int8_t *)(p->val);
-            ESP_LOGI(BT_AV_TAG, "--RSSI: %d", rssi);
+            ESP_LOGD(BT_AV_TAG, "--RSSI: %d", rssi);
             break;
         case ESP_BT_GAP_DEV_PROP_EIR:
             eir = (uint8_t *)(p->val);
@@ -404,24 +424,30 @@ void BluetoothA2DPSource::filter_inquiry_scan_result(esp_bt_gap_cb_param_t *para
             !(esp_bt_gap_get_cod_srvc(cod) & ESP_BT_COD_SRVC_RENDERING)) {
         return;
     }
+    discovery_stats.rendering_devices++;
 
     /* search for device name in its extended inqury response */
     if (eir) {
-        get_name_from_eir(eir, s_peer_bdname, NULL);
-        ESP_LOGI(BT_AV_TAG, "Device discovery found: %s", s_peer_bdname);
-
-        bool found = false;
-        for (const char* name : bt_names){
-            int len = strlen(name);
-            ESP_LOGI(BT_AV_TAG, "Checking name: %s", name);
-            if (strncmp((char *)s_peer_bdname, name, len) == 0) {
-                this->bt_name = (char *) s_peer_bdname;
-                found = true;
-                break;
-            }
+        uint8_t bdname[ESP_BT_GAP_MAX_BDNAME_LEN + 1] = {0};
+        if (!get_name_from_eir(eir, bdname, NULL)) {
+            return;
         }
-        if (found){
-            ESP_LOGI(BT_AV_TAG, "Found a target device, address %s, name %s", to_str(param->disc_res.bda), s_peer_bdname);
+        ESP_LOGD(BT_AV_TAG, "Device discovery found: %s", bdname);
+
+        if (match_name((char *)bdname) == nullptr){
+            return;
+        }
+        discovery_stats.name_matches++;
+
+        if (is_ranked_discovery){
+            // collect the candidate: we decide at the end of the inquiry window
+            add_discovery_candidate(param->disc_res.bda, bdname, cod, rssi);
+        } else {
+            ESP_LOGI(BT_AV_TAG, "Found a target device, address %s, name %s", to_str(param->disc_res.bda), bdname);
+            strcpy((char *)s_peer_bdname, (char *)bdname);
+            this->bt_name = (char *) s_peer_bdname;
+            s_peer_cod = cod;
+            s_peer_rssi = rssi;
             s_a2d_state = APP_AV_STATE_DISCOVERED;
             memcpy(s_peer_bda, param->disc_res.bda, ESP_BD_ADDR_LEN);
             set_last_connection(s_peer_bda);
@@ -431,6 +457,250 @@ void BluetoothA2DPSource::filter_inquiry_scan_result(esp_bt_gap_cb_param_t *para
     }
 }
 
+void BluetoothA2DPSource::start_discovery() {
+    discovery_candidates.clear();
+    discovery_candidates.reserve(A2DP_DISCOVERY_MAX_CANDIDATES);
+    discovery_stats = bt_discovery_stats_t();
+    discovery_stats.start_ms = millis();
+    esp_bt_gap_start_discovery(ESP_BT_INQ_MODE_GENERAL_INQUIRY, is_ranked_discovery ? ranked_inquiry_len : 10, 0);
+}
+
+/// FNV-1a hash of the first len characters
+static uint32_t bt_name_hash(const char* str, int len) {
+    uint32_t hash = 2166136261u;
+    for (int j=0; j<len; j++){
+        hash ^= (uint8_t) str[j];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void BluetoothA2DPSource::setup_name_filter() {
+    bt_name_lengths.clear();
+    bt_name_hashes.clear();
+    for (const char* name : bt_names){
+        int len = strlen(name);
+        if (std::find(bt_name_lengths.begin(), bt_name_lengths.end(), len) == bt_name_lengths.end()){
+            bt_name_lengths.push_back(len);
+        }
+        bt_name_hashes.emplace(bt_name_hash(name, len), name);
+    }
+}
+
+/// Returns the configured name which is a prefix of the indicated device name (or nullptr)
+const char* BluetoothA2DPSource::match_name(const char* name) {
+    int name_len = strlen(name);
+    for (int len : bt_name_lengths){
+        if (len > name_len) continue;
+        auto range = bt_name_hashes.equal_range(bt_name_hash(name, len));
+        for (auto it = range.first; it != range.second; ++it){
+            if (strncmp(name, it->second, len) == 0) {
+                return it->second;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool BluetoothA2DPSource::is_known_device(esp_bd_addr_t bda) {
+    for (auto &device : known_devices){
+        if (memcmp(bda, device.bda, ESP_BD_ADDR_LEN) == 0){
+            return true;
+        }
+    }
+    return has_last_connection() && memcmp(bda, last_connection, ESP_BD_ADDR_LEN) == 0;
+}
+
+void BluetoothA2DPSource::add_discovery_candidate(esp_bd_addr_t bda, uint8_t *name, uint32_t cod, int32_t rssi) {
+    // the same device might be reported multiple times: keep the best rssi
+    for (auto &candidate : discovery_candidates){
+        if (memcmp(candidate.bda, bda, ESP_BD_ADDR_LEN) == 0){
+            candidate.rssi = std::max(candidate.rssi, rssi);
+            return;
+        }
+    }
+    if (discovery_candidates.size() >= A2DP_DISCOVERY_MAX_CANDIDATES){
+        ESP_LOGD(BT_AV_TAG, "Ignoring candidate %s: too many candidates", to_str(bda));
+        return;
+    }
+
+    bt_discovery_candidate_t candidate;
+    memcpy(candidate.bda, bda, ESP_BD_ADDR_LEN);
+    strcpy((char *)candidate.name, (char *)name);
+    candidate.cod = cod;
+    candidate.rssi = rssi;
+    candidate.is_known = is_known_device(bda);
+    discovery_candidates.push_back(candidate);
+}
+
+/// Selects the best candidate of the inquiry window: returns true if we found one
+bool BluetoothA2DPSource::select_discovery_candidate() {
+    bt_discovery_candidate_t *best = nullptr;
+    int32_t best_score = INT32_MIN;
+    for (auto &candidate : discovery_candidates){
+        int32_t score = candidate.rssi + (candidate.is_known ? A2DP_KNOWN_DEVICE_RSSI_BONUS : 0);
+        if (score > best_score){
+            best_score = score;
+            best = &candidate;
+        }
+    }
+    if (best == nullptr){
+        return false;
+    }
+
+    ESP_LOGI(BT_AV_TAG, "Selected target device, address %s, name %s, rssi %d%s", to_str(best->bda), best->name, best->rssi, best->is_known ? " (known)" : "");
+    strcpy((char *)s_peer_bdname, (char *)best->name);
+    this->bt_name = (char *) s_peer_bdname;
+    s_peer_cod = best->cod;
+    s_peer_rssi = best->rssi;
+    memcpy(s_peer_bda, best->bda, ESP_BD_ADDR_LEN);
+    set_last_connection(s_peer_bda);
+    s_a2d_state = APP_AV_STATE_DISCOVERED;
+    return true;
+}
+
+void BluetoothA2DPSource::get_known_devices() {
+    ESP_LOGD(BT_AV_TAG, "%s", __func__);
+    known_devices.clear();
+
+    nvs_handle my_handle;
+    esp_err_t err = nvs_open("connected_bda", NVS_READWRITE, &my_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(BT_AV_TAG,"NVS OPEN ERROR");
+    } else {
+        bt_known_device_t devices[A2DP_KNOWN_DEVICES_MAX];
+        size_t size = sizeof(devices);
+        err = nvs_get_blob(my_handle, known_devices_nvs_name(), devices, &size);
+        if (err == ESP_OK) {
+            known_devices.assign(devices, devices + size / sizeof(bt_known_device_t));
+        } else if (err == ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGI(BT_AV_TAG, "nvs_blob does not exist");
+        } else {
+            ESP_LOGE(BT_AV_TAG, "nvs_get_blob failed");
+        }
+        nvs_close(my_handle);
+    }
+
+    // the last connection (which might have been defined with set_auto_reconnect) is paged first
+    if (has_last_connection()){
+        bt_known_device_t device;
+        memset(&device, 0, sizeof(device));
+        memcpy(device.bda, last_connection, ESP_BD_ADDR_LEN);
+        device.rssi = -129;
+        for (auto it = known_devices.begin(); it != known_devices.end(); ++it){
+            if (memcmp(it->bda, last_connection, ESP_BD_ADDR_LEN) == 0){
+                device = *it;
+                known_devices.erase(it);
+                break;
+            }
+        }
+        known_devices.insert(known_devices.begin(), device);
+    }
+    ESP_LOGI(BT_AV_TAG, "%d known devices", (int) known_devices.size());
+}
+
+void BluetoothA2DPSource::set_known_devices() {
+    ESP_LOGD(BT_AV_TAG, "%s", __func__);
+    nvs_handle my_handle;
+    esp_err_t err = nvs_open("connected_bda", NVS_READWRITE, &my_handle);
+    if (err != ESP_OK){
+        ESP_LOGE(BT_AV_TAG, "NVS OPEN ERROR");
+        return;
+    }
+    if (known_devices.empty()){
+        err = nvs_erase_key(my_handle, known_devices_nvs_name());
+        if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;
+    } else {
+        err = nvs_set_blob(my_handle, known_devices_nvs_name(), known_devices.data(), known_devices.size() * sizeof(bt_known_device_t));
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(my_handle);
+    } else {
+        ESP_LOGE(BT_AV_TAG, "NVS WRITE ERROR");
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(BT_AV_TAG, "NVS COMMIT ERROR");
+    }
+    nvs_close(my_handle);
+}
+
+void BluetoothA2DPSource::clean_known_devices() {
+    ESP_LOGD(BT_AV_TAG, "%s", __func__);
+    known_devices.clear();
+    set_known_devices();
+}
+
+/// Moves the connected peer to the front of the known devices and persists the table
+void BluetoothA2DPSource::update_known_device() {
+    bt_known_device_t device;
+    memset(&device, 0, sizeof(device));
+    device.rssi = -129;
+    for (auto it = known_devices.begin(); it != known_devices.end(); ++it){
+        if (memcmp(it->bda, s_peer_bda, ESP_BD_ADDR_LEN) == 0){
+            device = *it;
+            known_devices.erase(it);
+            break;
+        }
+    }
+
+    // keep the recorded properties if we did not get any new ones from an inquiry
+    memcpy(device.bda, s_peer_bda, ESP_BD_ADDR_LEN);
+    if (s_peer_bdname[0] != 0) {
+        strncpy(device.name, (char *)s_peer_bdname, ESP_BT_GAP_MAX_BDNAME_LEN);
+    }
+    if (s_peer_cod != 0) {
+        device.cod = s_peer_cod;
+    }
+    if (s_peer_rssi != -129) {
+        device.rssi = s_peer_rssi;
+    }
+    device.last_success = time(nullptr);
+
+    known_devices.insert(known_devices.begin(), device);
+    if (known_devices.size() > A2DP_KNOWN_DEVICES_MAX){
+        known_devices.resize(A2DP_KNOWN_DEVICES_MAX);
+    }
+    set_known_devices();
+}
+
+/// Pages the next known device in LRU order: returns false if all of them have been tried
+bool BluetoothA2DPSource::page_next_known_device() {
+    if (++known_device_page_idx >= (int) known_devices.size()){
+        known_device_page_idx = -1;
+        return false;
+    }
+    bt_known_device_t &device = known_devices[known_device_page_idx];
+    memcpy(s_peer_bda, device.bda, ESP_BD_ADDR_LEN);
+    strcpy((char *)s_peer_bdname, device.name);
+    s_peer_cod = device.cod;
+    s_peer_rssi = -129;
+    connect_stats.pages++;
+
+    ESP_LOGI(BT_AV_TAG, "Paging known device %d: %s %s", known_device_page_idx, to_str(s_peer_bda), s_peer_bdname);
+    esp_a2d_source_connect(s_peer_bda);
+    s_a2d_state = APP_AV_STATE_CONNECTING;
+    s_connecting_intv = 0;
+    return true;
+}
+
+/// A connection attempt failed: we try the next known device and fall back to an inquiry
+void BluetoothA2DPSource::connect_failed() {
+    s_connecting_intv = 0;
+    if (known_device_page_idx < 0) {
+        s_a2d_state = APP_AV_STATE_UNCONNECTED;
+    } else if (!page_next_known_device()) {
+        ESP_LOGI(BT_AV_TAG, "No known device available: starting device discovery...");
+        s_a2d_state = APP_AV_STATE_DISCOVERING;
+        start_discovery();
+    }
+}
+
+void BluetoothA2DPSource::log_discovery_stats() {
+    ESP_LOGI(BT_AV_TAG, "Discovery: %u ms, %u devices, %u rendering, %u name matches, %u candidates", 
+        (unsigned) (millis() - discovery_stats.start_ms), discovery_stats.devices_seen, discovery_stats.rendering_devices, 
+        discovery_stats.name_matches, (unsigned) discovery_candidates.size());
+}
+
 
 void BluetoothA2DPSource::bt_app_gap_callback(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t *param)
 {
@@ -441,16 +711,24 @@ void BluetoothA2DPSource::bt_app_gap_callback(esp_bt_gap_cb_event_t event, esp_b
         }
         case ESP_BT_GAP_DISC_STATE_CHANGED_EVT: {
             if (param->disc_st_chg.state == ESP_BT_GAP_DISCOVERY_STOPPED) {
+                if (is_ranked_discovery && s_a2d_state == APP_AV_STATE_DISCOVERING) {
+                    select_discovery_candidate();
+                }
+                log_discovery_stats();
                 if (s_a2d_state == APP_AV_STATE_DISCOVERED) {
                     s_a2d_state = APP_AV_STATE_CONNECTING;
+                    s_connecting_intv = 0;
                     ESP_LOGI(BT_AV_TAG, "Device discovery stopped.");
                     ESP_LOGI(BT_AV_TAG, "a2dp connecting to peer: %s", s_peer_bdname);
+                    connect_stats.via_inquiry = true;
                     esp_a2d_source_connect(s_peer_bda);
                 } else {
                     // not discovered, continue to discover
                     ESP_LOGI(BT_AV_TAG, "Device discovery failed, continue to discover...");
-                    esp_bt_gap_start_discovery(ESP_BT_INQ_MODE_GENERAL_INQUIRY, 10, 0);
+                    start_discovery();
                 }
+                // the timer is only changed by the app task
+                bt_app_work_dispatch(ccall_bt_app_update_heart_beat, 0, NULL, 0, NULL);
             } else if (param->disc_st_chg.state == ESP_BT_GAP_DISCOVERY_STARTED) {
                 ESP_LOGI(BT_AV_TAG, "Discovery started.");
             }
@@ -535,22 +813,24 @@ void BluetoothA2DPSource::bt_av_hdl_stack_evt(uint16_t event, void *p_param)
             esp_a2d_source_init();
             set_scan_mode_connectable(true);
 
-            if (is_auto_reconnect && has_last_connection()) {
-                ESP_LOGI(BT_AV_TAG, "Reconnecting to %s", to_str(last_connection));
-                memcpy(s_peer_bda,last_connection,ESP_BD_ADDR_LEN);
-                esp_a2d_source_connect(last_connection);
-                s_a2d_state = APP_AV_STATE_CONNECTING;
+            connect_stats = bt_connect_stats_t();
+            connect_stats.start_ms = millis();
+            if (is_auto_reconnect && !known_devices.empty()) {
+                // page the known devices in LRU order before we fall back to an inquiry
+                known_device_page_idx = -1;
+                page_next_known_device();
             } else {
             //  start device discovery 
                 ESP_LOGI(BT_AV_TAG, "Starting device discovery...");
                 s_a2d_state = APP_AV_STATE_DISCOVERING;
-                esp_bt_gap_start_discovery(ESP_BT_INQ_MODE_GENERAL_INQUIRY, 10, 0);
+                start_discovery();
             }
 
-            // create and start heart beat timer 
+            // create and start heart beat timer: the interval is adapted to the state
             do {
                 int tmr_id = 0;
-                s_tmr = xTimerCreate("connTmr", (10000 / portTICK_RATE_MS), pdTRUE, (void *)tmr_id, ccall_a2d_app_heart_beat);
+                heart_beat_ms = heart_beat_interval();
+                s_tmr = xTimerCreate("connTmr", (heart_beat_ms / portTICK_RATE_MS), pdTRUE, (void *)tmr_id, ccall_a2d_app_heart_beat);
                 xTimerStart(s_tmr, portMAX_DELAY);
             } while (0);
             
@@ -575,6 +855,35 @@ void BluetoothA2DPSource::a2d_app_heart_beat(void *arg)
 }
 
 
+/// Determines the heart beat interval: fast while connecting or starting the media, slow otherwise
+uint32_t BluetoothA2DPSource::heart_beat_interval() {
+    switch (s_a2d_state) {
+        case APP_AV_STATE_CONNECTING:
+            return A2DP_HEART_BEAT_FAST_MS;
+        case APP_AV_STATE_CONNECTED:
+            return s_media_state == APP_AV_MEDIA_STATE_STARTED ? A2DP_HEART_BEAT_IDLE_MS : A2DP_HEART_BEAT_FAST_MS;
+        default:
+            return A2DP_HEART_BEAT_IDLE_MS;
+    }
+}
+
+/// Changes the period of the heart beat timer if the state requires a different interval: only call it from the app task
+void BluetoothA2DPSource::update_heart_beat() {
+    uint32_t ms = heart_beat_interval();
+    if (s_tmr != nullptr && ms != heart_beat_ms) {
+        ESP_LOGD(BT_AV_TAG, "heart beat: %u ms", ms);
+        heart_beat_ms = ms;
+        xTimerChangePeriod(s_tmr, ms / portTICK_RATE_MS, 0);
+    }
+}
+
+/// Restarts the heart beat interval e.g. after we got an ACK
+void BluetoothA2DPSource::rearm_heart_beat() {
+    if (s_tmr != nullptr) {
+        xTimerReset(s_tmr, 0);
+    }
+}
+
 void BluetoothA2DPSource::process_user_state_callbacks(uint16_t event, void *param){
     ESP_LOGD(BT_AV_TAG, "%s", __func__);
 
@@ -631,6 +940,7 @@ void BluetoothA2DPSource::bt_app_av_sm_hdlr(uint16_t event, void *param)
             ESP_LOGE(BT_AV_TAG, "%s invalid state %d", __func__, s_a2d_state);
             break;
     }
+    update_heart_beat();
 }
 
 void BluetoothA2DPSource::bt_app_av_state_unconnected(uint16_t event, void *param)
@@ -650,6 +960,8 @@ void BluetoothA2DPSource::bt_app_av_state_unconnected(uint16_t event, void *para
         case BT_APP_HEART_BEAT_EVT: {
             uint8_t *p = s_peer_bda;
             ESP_LOGI(BT_AV_TAG, "a2dp connecting to peer: %02x:%02x:%02x:%02x:%02x:%02x", p[0], p[1], p[2], p[3], p[4], p[5]);
+            connect_stats = bt_connect_stats_t();
+            connect_stats.start_ms = millis();
             esp_a2d_source_connect(s_peer_bda);
             s_a2d_state = APP_AV_STATE_CONNECTING;
             s_connecting_intv = 0;
@@ -672,9 +984,14 @@ void BluetoothA2DPSource::bt_app_av_state_connecting(uint16_t event, void *param
                 s_a2d_state =  APP_AV_STATE_CONNECTED;
                 s_media_state = APP_AV_MEDIA_STATE_IDLE;
                 set_scan_mode_connectable(false);
+                known_device_page_idx = -1;
+                connect_stats.connected_ms = millis() - connect_stats.start_ms;
+                update_known_device();
+                // check if the media is ready without waiting for the next heart beat
+                a2d_app_heart_beat(nullptr);
 
             } else if (a2d->conn_stat.state == ESP_A2D_CONNECTION_STATE_DISCONNECTED) {
-                s_a2d_state =  APP_AV_STATE_UNCONNECTED;
+                connect_failed();
             }
             break;
         }
@@ -683,12 +1000,12 @@ void BluetoothA2DPSource::bt_app_av_state_connecting(uint16_t event, void *param
         case ESP_A2D_MEDIA_CTRL_ACK_EVT:
             break;
         case BT_APP_HEART_BEAT_EVT:
-            if (++s_connecting_intv >= 5) {
+            s_connecting_intv += heart_beat_ms;
+            if (s_connecting_intv >= A2DP_CONNECT_TIMEOUT_MS) {
                 ESP_LOGW(BT_AV_TAG,"setting APP_AV_STATE_UNCONNECTED");
                 // just to make sure that the remote devices knows about this
                 esp_a2d_sink_disconnect(s_peer_bda);
-                s_a2d_state = APP_AV_STATE_UNCONNECTED;
-                s_connecting_intv = 0;
+                connect_failed();
             }
             break;
         default:
@@ -725,6 +1042,9 @@ void BluetoothA2DPSource::bt_app_av_media_proc(uint16_t event, void *param)
                     ESP_LOGI(BT_AV_TAG, "a2dp media start successfully.");
                     s_intv_cnt = 0;
                     s_media_state = APP_AV_MEDIA_STATE_STARTED;
+                    connect_stats.first_audio_ms = millis() - connect_stats.start_ms;
+                    ESP_LOGI(BT_AV_TAG, "time to first audio: %u ms (connected after %u ms, %d pages%s)", connect_stats.first_audio_ms, 
+                        connect_stats.connected_ms, connect_stats.pages, connect_stats.via_inquiry ? ", inquiry" : "");
                 } else {
                     // not started succesfully, transfer to idle state
                     ESP_LOGI(BT_AV_TAG, "a2dp media start failed.");
@@ -780,6 +1100,10 @@ void BluetoothA2DPSource::bt_app_av_state_connected(uint16_t event, void *param)
             // not suppposed to occur for A2DP source
             break;
         case ESP_A2D_MEDIA_CTRL_ACK_EVT:
+            bt_app_av_media_proc(event, param);
+            // the next check follows one interval after the ACK
+            rearm_heart_beat();
+            break;
         case BT_APP_HEART_BEAT_EVT: {
             bt_app_av_media_proc(event, param);
             break;
@@ -909,6 +1233,7 @@ bool BluetoothA2DPSource::has_sound_data() {
 }
 
 bool BluetoothA2DPSource::write_data(SoundData *data){
+    is_pcm_mode.store(false, std::memory_order_release);
     this->sound_data = data;
     this->sound_data_current_pos = 0;
     this->hasSoundData = true;
@@ -942,6 +1267,70 @@ int32_t BluetoothA2DPSource::get_data_default(uint8_t *data, int32_t len) {
     return result_len;
 }
 
+void BluetoothA2DPSource::set_data_callback(music_data_cb_t callback) {
+    is_pcm_mode.store(false, std::memory_order_release);
+    this->data_stream_callback = callback;
+}
+
+void BluetoothA2DPSource::set_pcm_buffer_size(int32_t frames) {
+    pcm_buffer_size = frames;
+    FrameRingBuffer *buffer = pcm_buffer.load(std::memory_order_acquire);
+    if (buffer == nullptr) {
+        // the buffer is completely built before the data callback can see it
+        pcm_buffer.store(new FrameRingBuffer(frames), std::memory_order_release);
+    } else if (buffer->size() < frames) {
+        ESP_LOGE(BT_APP_TAG, "%s: the buffer has already been allocated with %d frames", __func__, buffer->size());
+    }
+}
+
+int32_t BluetoothA2DPSource::write_pcm(const Frame *data, int32_t len, uint32_t timeout_ms) {
+    if (pcm_buffer.load(std::memory_order_acquire) == nullptr) {
+        set_pcm_buffer_size(pcm_buffer_size);
+    }
+    FrameRingBuffer *buffer = pcm_buffer.load(std::memory_order_acquire);
+    is_pcm_mode.store(true, std::memory_order_release);
+    int32_t result = buffer->write(data, len);
+    uint32_t start = millis();
+    // wait until the data callback has made some space
+    while (result < len && millis() - start < timeout_ms) {
+        delay(1);
+        result += buffer->write(data + result, len - result);
+    }
+    // single writer: a relaxed load and store of each counter is enough
+    auto &written = pcm_written_stats;
+    written.frames_written.store(written.frames_written.load(std::memory_order_relaxed) + result, std::memory_order_relaxed);
+    written.frames_dropped.store(written.frames_dropped.load(std::memory_order_relaxed) + len - result, std::memory_order_relaxed);
+    int32_t fill = buffer->available();
+    if (fill > written.max_fill.load(std::memory_order_relaxed)) {
+        written.max_fill.store(fill, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+int32_t BluetoothA2DPSource::get_data_pcm(uint8_t *data, int32_t len) {
+    Frame *frames = (Frame*) data;
+    int32_t frame_count = len / 4;
+    // is_pcm_mode has been read with acquire, so the buffer which has been stored before it is complete
+    FrameRingBuffer *buffer = pcm_buffer.load(std::memory_order_acquire);
+    int32_t fill = buffer->available();
+    int32_t result = buffer->read(frames, frame_count);
+    auto &read = pcm_read_stats;
+    uint32_t frames_read = read.frames_read.load(std::memory_order_relaxed) + result;
+    read.frames_read.store(frames_read, std::memory_order_relaxed);
+    if (pcm_written_stats.frames_written.load(std::memory_order_relaxed) > 0) {
+        if (frames_read == (uint32_t) result || fill < read.min_fill.load(std::memory_order_relaxed)) {
+            read.min_fill.store(fill, std::memory_order_relaxed);
+        }
+        if (result < frame_count) {
+            read.underruns.store(read.underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            read.silence_frames.store(read.silence_frames.load(std::memory_order_relaxed) + frame_count - result,
+                                      std::memory_order_relaxed);
+        }
+    }
+    // underrun: we continue with silence
+    memset(data + result * 4, 0, (frame_count - result) * 4);
+    return frame_count * 4;
+}
 
 void BluetoothA2DPSource::set_nvs_init(bool doInit){
     nvs_init = doInit;
@@ -19,7 +19,9 @@
 #pragma once
 
 #include <vector> 
+#include <unordered_map>
 #include "BluetoothA2DPCommon.h"
+#include "FrameRingBuffer.h"
 
 typedef void (* bt_app_cb_t) (uint16_t event, void *param);
 typedef  int32_t (* music_data_cb_t) (uint8_t *data, int32_t len);
@@ -31,6 +33,7 @@ extern "C" void ccall_bt_app_task_handler(void *arg);
 extern "C" void ccall_bt_app_gap_callback(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t *param);
 extern "C" void ccall_bt_app_rc_ct_cb(esp_avrc_ct_cb_event_t event, esp_avrc_ct_cb_param_t *param);
 extern "C" void ccall_a2d_app_heart_beat(void *arg) ;
+extern "C" void ccall_bt_app_update_heart_beat(uint16_t event, void *param);
 extern "C" void ccall_bt_app_a2d_cb(esp_a2d_cb_event_t event, esp_a2d_cb_param_t *param);
 extern "C" void ccall_bt_app_av_sm_hdlr(uint16_t event, void *param);
 extern "C" void ccall_bt_av_hdl_avrc_ct_evt(uint16_t event, void *param) ;
@@ -38,6 +41,63 @@ extern "C" int32_t ccall_bt_app_a2d_data_cb(uint8_t *data, int32_t len);
 extern "C" int32_t ccall_get_channel_data_wrapper(uint8_t *data, int32_t len) ;
 extern "C" int32_t ccall_get_data_default(uint8_t *data, int32_t len) ;
 
+/**
+ * @brief Device which has been found during a ranked inquiry window
+ */
+struct bt_discovery_candidate_t {
+    esp_bd_addr_t bda;
+    uint8_t name[ESP_BT_GAP_MAX_BDNAME_LEN + 1];
+    uint32_t cod;
+    int32_t rssi;
+    bool is_known;
+};
+
+/**
+ * @brief Sink which we have been connected to: persisted in NVS in LRU order
+ */
+struct bt_known_device_t {
+    esp_bd_addr_t bda;
+    char name[ESP_BT_GAP_MAX_BDNAME_LEN + 1];
+    uint32_t cod;
+    int32_t rssi;
+    uint32_t last_success; // time() of the last successful connection
+};
+
+/**
+ * @brief Timing of the last connection: all values are in ms since the start of the connection attempt
+ */
+struct bt_connect_stats_t {
+    uint32_t start_ms = 0;
+    uint32_t connected_ms = 0;
+    uint32_t first_audio_ms = 0;
+    uint8_t pages = 0;
+    bool via_inquiry = false;
+};
+
+/**
+ * @brief Statistics of the buffer which is filled by write_pcm (all values in frames)
+ */
+struct bt_pcm_stats_t {
+    uint32_t frames_written = 0;
+    uint32_t frames_read = 0;
+    uint32_t frames_dropped = 0; // not written because the buffer was full
+    uint32_t silence_frames = 0; // filled with silence because the buffer was empty
+    uint32_t underruns = 0;
+    int32_t fill = 0;
+    int32_t max_fill = 0;
+    int32_t min_fill = 0;       // lowest fill level before a read after the first write
+};
+
+/**
+ * @brief Statistics of the last inquiry window
+ */
+struct bt_discovery_stats_t {
+    uint32_t start_ms = 0;
+    uint16_t devices_seen = 0;
+    uint16_t rendering_devices = 0;
+    uint16_t name_matches = 0;
+};
+
 
 /**
  * @brief A2DP Bluetooth Source
@@ -51,6 +111,7 @@ class BluetoothA2DPSource : public BluetoothA2DPCommon {
   friend void ccall_bt_app_gap_callback(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t *param);
   friend void ccall_bt_app_rc_ct_cb(esp_avrc_ct_cb_event_t event, esp_avrc_ct_cb_param_t *param);
   friend void ccall_a2d_app_heart_beat(void *arg) ;
+  friend void ccall_bt_app_update_heart_beat(uint16_t event, void *param);
   friend void ccall_bt_app_a2d_cb(esp_a2d_cb_event_t event, esp_a2d_cb_param_t *param);
   friend void ccall_bt_app_av_sm_hdlr(uint16_t event, void *param);
   friend void ccall_bt_av_hdl_avrc_ct_evt(uint16_t event, void *param) ;
@@ -87,6 +148,38 @@ class BluetoothA2DPSource : public BluetoothA2DPCommon {
       bt_name = name;
     }
 
+    /**
+     * @brief Collects all matching devices during an inquiry window of inquiry_len * 1.28s and connects
+     * to the best one (by RSSI and by known devices) instead of connecting to the first match
+     */
+    virtual void set_ranked_discovery(bool active, uint8_t inquiry_len=5){
+      this->is_ranked_discovery = active;
+      this->ranked_inquiry_len = inquiry_len;
+    }
+
+    /// Provides the statistics of the last inquiry window
+    virtual const bt_discovery_stats_t& get_discovery_stats(){
+      return discovery_stats;
+    }
+
+    /// Provides the timing of the last connection (time to first audio)
+    virtual const bt_connect_stats_t& get_connect_stats(){
+      return connect_stats;
+    }
+
+    /// Provides the number of known sinks
+    virtual int known_device_count(){
+      return known_devices.size();
+    }
+
+    /// Provides the known sink at the indicated LRU position (0 = most recent)
+    virtual const bt_known_device_t& known_device(int idx){
+      return known_devices[idx];
+    }
+
+    /// Forgets all known sinks
+    virtual void clean_known_devices();
+
     /**
      * @brief starts the bluetooth source
      * @param name: Bluetooth name of the device to connect to
@@ -123,6 +216,35 @@ class BluetoothA2DPSource : public BluetoothA2DPCommon {
      */
     virtual bool write_data(SoundData *data);
 
+    /// Defines the callback which provides the audio data: like write_data() this ends the write_pcm mode
+    virtual void set_data_callback(music_data_cb_t callback);
+
+    /// Defines the capacity (in frames) of the buffer which is used by write_pcm: call before start
+    virtual void set_pcm_buffer_size(int32_t frames);
+
+    /**
+     * @brief Push interface: writes frames to a lock free ring buffer which is drained by the A2DP data callback.
+     * Waits up to timeout_ms if the buffer is full and returns the number of frames which have been written.
+     * Must be called from a single producer task. The data is taken from the buffer instead of the data callback
+     * until write_data() or set_data_callback() is called.
+     */
+    virtual int32_t write_pcm(const Frame *data, int32_t len, uint32_t timeout_ms=0);
+
+    /// Provides a snapshot of the statistics of the write_pcm buffer: can be called from any task
+    virtual bt_pcm_stats_t get_pcm_stats(){
+      bt_pcm_stats_t stats;
+      stats.frames_written = pcm_written_stats.frames_written.load(std::memory_order_relaxed);
+      stats.frames_dropped = pcm_written_stats.frames_dropped.load(std::memory_order_relaxed);
+      stats.max_fill = pcm_written_stats.max_fill.load(std::memory_order_relaxed);
+      stats.frames_read = pcm_read_stats.frames_read.load(std::memory_order_relaxed);
+      stats.silence_frames = pcm_read_stats.silence_frames.load(std::memory_order_relaxed);
+      stats.underruns = pcm_read_stats.underruns.load(std::memory_order_relaxed);
+      stats.min_fill = pcm_read_stats.min_fill.load(std::memory_order_relaxed);
+      FrameRingBuffer *buffer = pcm_buffer.load(std::memory_order_acquire);
+      stats.fill = buffer != nullptr ? buffer->available() : 0;
+      return stats;
+    }
+
     /// Returns true if the bluetooth device is connected
     virtual  bool is_connected();
 
@@ -156,6 +278,9 @@ class BluetoothA2DPSource : public BluetoothA2DPCommon {
     /// callback for data
     virtual int32_t get_data_default(uint8_t *data, int32_t len);
 
+    /// callback for data which has been provided with write_pcm
+    virtual int32_t get_data_pcm(uint8_t *data, int32_t len);
+
 
   protected:
     music_data_channels_cb_t data_stream_channels_callback;
@@ -164,6 +289,20 @@ class BluetoothA2DPSource : public BluetoothA2DPCommon {
     bool ssp_enabled=false;
     const char* bt_name;
     std::vector<const char*> bt_names;
+    // precomputed name filter: distinct name lengths and hash of names
+    std::vector<int> bt_name_lengths;
+    std::unordered_multimap<uint32_t, const char*> bt_name_hashes;
+
+    // ranked discovery
+    bool is_ranked_discovery = false;
+    uint8_t ranked_inquiry_len = 5;
+    std::vector<bt_discovery_candidate_t> discovery_candidates;
+    bt_discovery_stats_t discovery_stats;
+
+    // known sinks in LRU order and the index of the device which is currently paged (-1 = none)
+    std::vector<bt_known_device_t> known_devices;
+    int known_device_page_idx = -1;
+    bt_connect_stats_t connect_stats;
 
     esp_bt_pin_type_t pin_type;
     esp_bt_pin_code_t pin_code;
@@ -171,18 +310,40 @@ class BluetoothA2DPSource : public BluetoothA2DPCommon {
 
     esp_bd_addr_t s_peer_bda;
     uint8_t s_peer_bdname[ESP_BT_GAP_MAX_BDNAME_LEN + 1];
+    uint32_t s_peer_cod = 0;
+    int32_t s_peer_rssi = -129;
     int s_a2d_state; // Next Target Connection State
     int s_media_state;
     int s_intv_cnt=0;
-    int s_connecting_intv;
+    uint32_t s_connecting_intv; // ms since the start of the connection attempt
     uint32_t s_pkt_cnt;
-    TimerHandle_t s_tmr;
+    TimerHandle_t s_tmr = nullptr;
+    uint32_t heart_beat_ms = A2DP_HEART_BEAT_IDLE_MS;
     xQueueHandle s_bt_app_task_queue;
     xTaskHandle s_bt_app_task_handle;
     // support for raw data
     SoundData *sound_data;
     int32_t sound_data_current_pos;
     bool hasSoundData;
+    // support for write_pcm
+    // published with release by the producer, the data callback on the BT task reads it with acquire
+    std::atomic<FrameRingBuffer*> pcm_buffer{nullptr};
+    // true: the data callback reads from pcm_buffer instead of data_stream_callback / write_data
+    std::atomic<bool> is_pcm_mode{false};
+    int32_t pcm_buffer_size = A2DP_PCM_BUFFER_FRAMES;
+    // the statistics are split by the task which updates them: each side is the only writer of its counters,
+    // the other side and get_pcm_stats() only load them
+    struct {
+        std::atomic<uint32_t> frames_written{0};
+        std::atomic<uint32_t> frames_dropped{0};
+        std::atomic<int32_t> max_fill{0};
+    } pcm_written_stats; // write_pcm (producer)
+    struct {
+        std::atomic<uint32_t> frames_read{0};
+        std::atomic<uint32_t> silence_frames{0};
+        std::atomic<uint32_t> underruns{0};
+        std::atomic<int32_t> min_fill{0};
+    } pcm_read_stats; // get_data_pcm (BT task)
 
     // initialization
     bool nvs_init = true;
@@ -216,11 +377,30 @@ class BluetoothA2DPSource : public BluetoothA2DPCommon {
 
     virtual bool get_name_from_eir(uint8_t *eir, uint8_t *bdname, uint8_t *bdname_len);
     virtual void filter_inquiry_scan_result(esp_bt_gap_cb_param_t *param);
+    virtual void start_discovery();
+    virtual void setup_name_filter();
+    virtual const char* match_name(const char* name);
+    virtual bool is_known_device(esp_bd_addr_t bda);
+    virtual void add_discovery_candidate(esp_bd_addr_t bda, uint8_t *name, uint32_t cod, int32_t rssi);
+    virtual bool select_discovery_candidate();
+    virtual void log_discovery_stats();
+    virtual void get_known_devices();
+    virtual void set_known_devices();
+    virtual void update_known_device();
+    virtual bool page_next_known_device();
+    virtual void connect_failed();
+    virtual uint32_t heart_beat_interval();
+    virtual void update_heart_beat();
+    virtual void rearm_heart_beat();
 
     virtual const char* last_bda_nvs_name() {
         return "src_bda";
     }
 
+    virtual const char* known_devices_nvs_name() {
+        return "src_known";
+    }
+
     /**
      *  The following mthods are called by the framework. They are public so that they can
      *  be executed from a extern "C" function.
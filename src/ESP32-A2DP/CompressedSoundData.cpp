@@ -0,0 +1,257 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include "CompressedSoundData.h"
+#include <string.h>
+
+//*****************************************************************************************
+//  G711SoundData
+//*****************************************************************************************
+
+static int16_t g711_ulaw_table[256];
+static int16_t g711_alaw_table[256];
+static bool g711_tables_valid = false;
+
+/// Decoding as defined by ITU-T G.711
+static void g711_setup_tables() {
+    for (int32_t j=0; j<256; j++){
+        // u-law
+        int32_t u = ~j;
+        int32_t t = ((u & 0x0F) << 3) + 0x84;
+        t <<= (u & 0x70) >> 4;
+        g711_ulaw_table[j] = (u & 0x80) ? (0x84 - t) : (t - 0x84);
+
+        // A-law
+        int32_t a = j ^ 0x55;
+        int32_t seg = (a & 0x70) >> 4;
+        t = (a & 0x0F) << 4;
+        if (seg == 0) {
+            t += 8;
+        } else {
+            t = (t + 0x108) << (seg - 1);
+        }
+        g711_alaw_table[j] = (a & 0x80) ? t : -t;
+    }
+    g711_tables_valid = true;
+}
+
+G711SoundData::G711SoundData(const uint8_t *data, int32_t len, G711Law law, uint8_t channels, bool loop, ChannelInfo channelInfo) {
+    if (!g711_tables_valid){
+        g711_setup_tables();
+    }
+    this->table = law == ALaw ? g711_alaw_table : g711_ulaw_table;
+    this->channels = channels == 2 ? 2 : 1;
+    this->channelInfo = channelInfo;
+    setData(data, len);
+    setLoop(loop);
+}
+
+void G711SoundData::setData(const uint8_t *data, int32_t len) {
+    this->data = data;
+    this->len = len;
+}
+
+void G711SoundData::setDataRaw(uint8_t* data, int32_t len) {
+    setData(data, len);
+}
+
+int32_t G711SoundData::getData(int32_t pos, Frame &frame) {
+    return get2ChannelData(pos * 4, 4, (uint8_t*) &frame) / 4;
+}
+
+int32_t G711SoundData::get2ChannelData(int32_t pos, int32_t len, uint8_t *data) {
+    Frame *result_data = (Frame*) data;
+    int32_t frame_start = pos / 4;
+    int32_t frame_count = std::max(0, std::min(len / 4, count() - frame_start));
+    const uint8_t *source = this->data + frame_start * channels;
+
+    if (channels == 2) {
+        for (int32_t j=0; j<frame_count; j++){
+            result_data[j].channel1 = table[source[j*2]];
+            result_data[j].channel2 = table[source[j*2+1]];
+        }
+        return frame_count * 4;
+    }
+
+    switch(channelInfo){
+        case Left:
+            for (int32_t j=0; j<frame_count; j++){
+                result_data[j].channel1 = table[source[j]];
+                result_data[j].channel2 = 0;
+            }
+            break;
+        case Right:
+            for (int32_t j=0; j<frame_count; j++){
+                result_data[j].channel1 = 0;
+                result_data[j].channel2 = table[source[j]];
+            }
+            break;
+        case Both:
+        default:
+            for (int32_t j=0; j<frame_count; j++){
+                int16_t sample = table[source[j]];
+                result_data[j].channel1 = sample;
+                result_data[j].channel2 = sample;
+            }
+            break;
+    }
+    return frame_count * 4;
+}
+
+//*****************************************************************************************
+//  ImaAdpcmSoundData
+//*****************************************************************************************
+
+static const int16_t ima_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t ima_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/// Decoder state of one channel
+struct ima_adpcm_state_t {
+    int32_t predictor;
+    int32_t index;
+
+    inline int16_t decode(uint8_t nibble) {
+        int32_t step = ima_step_table[index];
+        int32_t diff = step >> 3;
+        if (nibble & 4) diff += step;
+        if (nibble & 2) diff += step >> 1;
+        if (nibble & 1) diff += step >> 2;
+        predictor += (nibble & 8) ? -diff : diff;
+        predictor = std::max(-32768, std::min(32767, predictor));
+        index = std::max(0, std::min(88, index + ima_index_table[nibble]));
+        return predictor;
+    }
+};
+
+ImaAdpcmSoundData::ImaAdpcmSoundData(const uint8_t *data, int32_t len, uint16_t block_align, uint8_t channels, bool loop, ChannelInfo channelInfo) {
+    this->channels = channels == 2 ? 2 : 1;
+    this->block_align = block_align;
+    this->channelInfo = channelInfo;
+    this->samples_per_block = samples_in_block(block_align);
+    this->block = new Frame[samples_per_block];
+    setData(data, len);
+    setLoop(loop);
+}
+
+ImaAdpcmSoundData::~ImaAdpcmSoundData() {
+    delete[] block;
+}
+
+void ImaAdpcmSoundData::setData(const uint8_t *data, int32_t len) {
+    this->data = data;
+    this->len = len;
+    this->block_idx = -1;
+    // the last block might be incomplete
+    this->frame_count = (len / block_align) * samples_per_block + samples_in_block(len % block_align);
+}
+
+void ImaAdpcmSoundData::setDataRaw(uint8_t* data, int32_t len) {
+    setData(data, len);
+}
+
+/// each block has a header of 4 bytes per channel (which contains the first sample) followed by
+/// groups of 4 bytes (8 samples) per channel
+int32_t ImaAdpcmSoundData::samples_in_block(int32_t bytes) {
+    int32_t header = 4 * channels;
+    if (bytes < header) {
+        return 0;
+    }
+    return 1 + (bytes - header) / header * 8;
+}
+
+void ImaAdpcmSoundData::decode_block(int32_t idx) {
+    const uint8_t *source = data + idx * block_align;
+    block_len = std::min((int32_t) samples_per_block, frame_count - idx * samples_per_block);
+    int16_t *target = (int16_t*) block;
+
+    for (int32_t ch=0; ch<channels; ch++){
+        const uint8_t *header = source + ch * 4;
+        ima_adpcm_state_t state;
+        state.predictor = (int16_t)(header[0] | (header[1] << 8));
+        state.index = std::min((int32_t) header[2], (int32_t) 88);
+        target[ch] = state.predictor;
+
+        // the 4 byte groups of the channels are interleaved: low nibble first
+        int32_t sample = 1;
+        for (const uint8_t *group = source + channels * 4 + ch * 4; sample < block_len; group += channels * 4){
+            for (int32_t b=0; b<4 && sample < block_len; b++){
+                target[sample * 2 + ch] = state.decode(group[b] & 0x0F);
+                sample++;
+                if (sample < block_len) {
+                    target[sample * 2 + ch] = state.decode(group[b] >> 4);
+                    sample++;
+                }
+            }
+        }
+    }
+
+    if (channels == 1) {
+        // we have decoded into channel1
+        switch(channelInfo){
+            case Left:
+                for (int32_t j=0; j<block_len; j++){
+                    block[j].channel2 = 0;
+                }
+                break;
+            case Right:
+                for (int32_t j=0; j<block_len; j++){
+                    block[j].channel2 = block[j].channel1;
+                    block[j].channel1 = 0;
+                }
+                break;
+            case Both:
+            default:
+                for (int32_t j=0; j<block_len; j++){
+                    block[j].channel2 = block[j].channel1;
+                }
+                break;
+        }
+    }
+    block_idx = idx;
+}
+
+int32_t ImaAdpcmSoundData::getData(int32_t pos, Frame &frame) {
+    return get2ChannelData(pos * 4, 4, (uint8_t*) &frame) / 4;
+}
+
+int32_t ImaAdpcmSoundData::get2ChannelData(int32_t pos, int32_t len, uint8_t *data) {
+    Frame *result_data = (Frame*) data;
+    int32_t frame_pos = pos / 4;
+    int32_t result_len = std::max(0, std::min(len / 4, frame_count - frame_pos));
+
+    int32_t done = 0;
+    while (done < result_len) {
+        // seeking is just a division: we only decode the blocks which we need
+        int32_t idx = frame_pos / samples_per_block;
+        if (idx != block_idx) {
+            decode_block(idx);
+        }
+        int32_t offset = frame_pos - idx * samples_per_block;
+        int32_t n = std::min(result_len - done, block_len - offset);
+        memcpy(result_data + done, block + offset, n * sizeof(Frame));
+        done += n;
+        frame_pos += n;
+    }
+    return result_len * 4;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include "SoundData.h"
+
+/**
+ * @brief Companding law of G711SoundData
+ */
+enum G711Law {
+    ULaw,
+    ALaw
+};
+
+/**
+ * @brief G.711 (8 bit u-law or A-law) data which is decoded with a lookup table. This halves the size
+ * compared to 16 bit PCM. The data can be prepared e.g. in the following way
+ *
+ * - Open any sound file in Audacity
+ *   - Select Tracks -> Resample and select 44100
+ *   - Export -> Export Audio -> Header Raw ; U-Law (or A-Law)
+ * - Convert to c file e.g. with "xxd -i alarm.raw alarm.c"
+ *
+ * The data of 2 channels is interleaved.
+ * @copyright Apache License Version 2
+ */
+class G711SoundData : public SoundData {
+  public:
+    G711SoundData(const uint8_t *data, int32_t len, G711Law law=ULaw, uint8_t channels=1, bool loop=false, ChannelInfo channelInfo=Both);
+    void setData(const uint8_t *data, int32_t len);
+    void setDataRaw(uint8_t* data, int32_t len);
+    int32_t getData(int32_t pos, Frame &frame);
+    int32_t get2ChannelData(int32_t pos, int32_t len, uint8_t *data);
+    /// the number of frames
+    int32_t count(){
+      return len / channels;
+    }
+
+  protected:
+    const uint8_t *data;
+    int32_t len;
+    const int16_t *table;
+    uint8_t channels;
+    ChannelInfo channelInfo;
+};
+
+/**
+ * @brief IMA-ADPCM data in the block layout which is used by WAV files (4 bit per sample). This needs
+ * only a quarter of the size of 16 bit PCM. Each block starts with the predictor and step index of each
+ * channel, so we can start to decode at any block boundary. Blocks are decoded as a whole into a small cache.
+ *
+ * The data can be prepared e.g. with "ffmpeg -i alarm.wav -ar 44100 -acodec adpcm_ima_wav -f data alarm.raw":
+ * the block size is reported by ffmpeg as block_align and must be provided to the constructor.
+ * @copyright Apache License Version 2
+ */
+class ImaAdpcmSoundData : public SoundData {
+  public:
+    ImaAdpcmSoundData(const uint8_t *data, int32_t len, uint16_t block_align=1024, uint8_t channels=1, bool loop=false, ChannelInfo channelInfo=Both);
+    ~ImaAdpcmSoundData();
+    void setData(const uint8_t *data, int32_t len);
+    void setDataRaw(uint8_t* data, int32_t len);
+    int32_t getData(int32_t pos, Frame &frame);
+    int32_t get2ChannelData(int32_t pos, int32_t len, uint8_t *data);
+    /// the number of frames
+    int32_t count(){
+      return frame_count;
+    }
+
+  protected:
+    const uint8_t *data;
+    int32_t len;
+    uint16_t block_align;
+    uint8_t channels;
+    ChannelInfo channelInfo;
+    int32_t samples_per_block;
+    int32_t frame_count;
+    Frame *block = nullptr;
+    int32_t block_idx = -1;
+    int32_t block_len = 0;
+
+    int32_t samples_in_block(int32_t bytes);
+    void decode_block(int32_t idx);
+};
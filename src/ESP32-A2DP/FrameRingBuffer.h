@@ -0,0 +1,92 @@
+#pragma once
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include <atomic>
+#include <string.h>
+#include "SoundData.h"
+
+/**
+ * @brief Lock free single producer / single consumer ring buffer of Frames.
+ * The capacity is rounded up to a power of 2.
+ * @copyright Apache License Version 2
+ */
+class FrameRingBuffer {
+    public:
+        FrameRingBuffer(int32_t capacity) {
+            size_value = 1;
+            while (size_value < (uint32_t) capacity) {
+                size_value <<= 1;
+            }
+            mask = size_value - 1;
+            buffer = new Frame[size_value];
+        }
+
+        ~FrameRingBuffer() {
+            delete[] buffer;
+        }
+
+        /// max number of frames which can be stored
+        int32_t size() {
+            return size_value;
+        }
+
+        /// number of frames which can be read
+        int32_t available() {
+            return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_relaxed);
+        }
+
+        /// number of frames which can be written
+        int32_t available_for_write() {
+            return size_value - (write_pos.load(std::memory_order_relaxed) - read_pos.load(std::memory_order_acquire));
+        }
+
+        /// writes up to len frames: may only be called by the producer
+        int32_t write(const Frame *data, int32_t len) {
+            uint32_t wpos = write_pos.load(std::memory_order_relaxed);
+            uint32_t rpos = read_pos.load(std::memory_order_acquire);
+            int32_t result = std::min(len, (int32_t)(size_value - (wpos - rpos)));
+            int32_t first = std::min(result, (int32_t)(size_value - (wpos & mask)));
+            memcpy(buffer + (wpos & mask), data, first * sizeof(Frame));
+            memcpy(buffer, data + first, (result - first) * sizeof(Frame));
+            write_pos.store(wpos + result, std::memory_order_release);
+            return result;
+        }
+
+        /// reads up to len frames: may only be called by the consumer
+        int32_t read(Frame *data, int32_t len) {
+            uint32_t rpos = read_pos.load(std::memory_order_relaxed);
+            uint32_t wpos = write_pos.load(std::memory_order_acquire);
+            int32_t result = std::min(len, (int32_t)(wpos - rpos));
+            int32_t first = std::min(result, (int32_t)(size_value - (rpos & mask)));
+            memcpy(data, buffer + (rpos & mask), first * sizeof(Frame));
+            memcpy(data + first, buffer, (result - first) * sizeof(Frame));
+            read_pos.store(rpos + result, std::memory_order_release);
+            return result;
+        }
+
+        /// discards all frames which can be read: may only be called by the consumer
+        void clear() {
+            read_pos.store(write_pos.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+    protected:
+        Frame *buffer;
+        uint32_t size_value;
+        uint32_t mask;
+        // positions are only increasing: the index is position & mask
+        std::atomic<uint32_t> write_pos{0};
+        std::atomic<uint32_t> read_pos{0};
+};
@@ -0,0 +1,195 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include "ResampledSoundData.h"
+#include <math.h>
+#include <string.h>
+#include <mutex>
+#include <vector>
+
+#define RESAMPLE_TAPS A2DP_RESAMPLE_TAPS
+#define RESAMPLE_HISTORY (RESAMPLE_TAPS - 1)
+// stop band attenuation of about 70 dB
+#define RESAMPLE_KAISER_BETA 7.0
+// Q14 coefficients: a phase may have a sum of absolute values of up to 4 without overflowing the 32 bit accumulator,
+// which 32 taps need to keep the gain of all phases the same
+#define RESAMPLE_SHIFT 14
+
+/// coefficient table of a ratio which is shared by all instances: at most one per supported input rate
+struct resample_table_t {
+    int32_t up;
+    int32_t down;
+    int16_t *coefficients;
+};
+
+static int32_t resample_gcd(int32_t a, int32_t b) {
+    while (b != 0) {
+        int32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/// modified Bessel function of the first kind (order 0) for the Kaiser window
+static double resample_bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k=1; k<32; k++){
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+static inline int16_t resample_saturate(int32_t value) {
+    value = (value + (1 << (RESAMPLE_SHIFT - 1))) >> RESAMPLE_SHIFT;
+    return value > 32767 ? 32767 : (value < -32768 ? -32768 : value);
+}
+
+ResampledSoundData::ResampledSoundData(SoundData *source, uint32_t input_rate, uint32_t output_rate, bool loop) {
+    this->source = source;
+    int32_t gcd = resample_gcd(output_rate, input_rate);
+    this->up = output_rate / gcd;
+    this->down = input_rate / gcd;
+    this->step_idx = down / up;
+    this->step_phase = down % up;
+    this->input = new Frame[RESAMPLE_HISTORY + A2DP_RESAMPLE_CHUNK_FRAMES];
+    this->coefficients = setup_coefficients(up, down);
+    setLoop(loop);
+}
+
+ResampledSoundData::~ResampledSoundData() {
+    // the coefficients are kept for the next instance of the ratio
+    delete[] input;
+}
+
+/// Kaiser windowed sinc low pass at the lower of the two nyquist frequencies, split up into the phases: the table of
+/// a ratio is only calculated once because this takes long with the double emulation of the ESP32
+const int16_t *ResampledSoundData::setup_coefficients(int32_t up, int32_t down) {
+    static std::mutex mutex;
+    static std::vector<resample_table_t> tables;
+    std::lock_guard<std::mutex> lock(mutex);
+    // the filter only depends on up and the cutoff: e.g. 8000, 16000 and 32000 Hz use the same table
+    for (const resample_table_t &table : tables) {
+        if (table.up == up && std::max(table.up, table.down) == std::max(up, down)) {
+            return table.coefficients;
+        }
+    }
+
+    int32_t len = RESAMPLE_TAPS * up;
+    double cutoff = 0.45 / std::max(up, down);
+    double center = (len - 1) / 2.0;
+    double window_norm = resample_bessel_i0(RESAMPLE_KAISER_BETA);
+    int16_t *coefficients = new int16_t[len];
+
+    for (int32_t p=0; p<up; p++){
+        double h[RESAMPLE_TAPS];
+        double abs_sum = 0;
+        for (int32_t k=0; k<RESAMPLE_TAPS; k++){
+            double x = p + k * up - center;
+            double w = 2.0 * x / (len - 1);
+            double window = resample_bessel_i0(RESAMPLE_KAISER_BETA * sqrt(std::max(0.0, 1.0 - w * w))) / window_norm;
+            double sinc = x == 0 ? 1.0 : sin(2.0 * M_PI * cutoff * x) / (2.0 * M_PI * cutoff * x);
+            // each phase has a gain of about 1
+            h[k] = 2.0 * cutoff * up * sinc * window;
+            abs_sum += fabs(h[k]);
+        }
+        // the accumulator of a phase must not overflow 32 bits
+        double scale = abs_sum > 3.99 ? 3.99 / abs_sum : 1.0;
+        for (int32_t k=0; k<RESAMPLE_TAPS; k++){
+            coefficients[p * RESAMPLE_TAPS + k] = (int16_t) lround(std::max(-32768.0, std::min(32767.0, h[k] * scale * (1 << RESAMPLE_SHIFT))));
+        }
+    }
+    tables.push_back({up, down, coefficients});
+    return coefficients;
+}
+
+/// continues at the indicated output frame: we reload the filter history from the source
+void ResampledSoundData::seek(int32_t frame) {
+    int64_t position = (int64_t) frame * down;
+    input_idx = position / up;
+    phase = position % up;
+    input_start = input_idx - RESAMPLE_HISTORY;
+    input_len = RESAMPLE_HISTORY;
+    memset((uint8_t*) input, 0, RESAMPLE_HISTORY * sizeof(Frame));
+    if (input_idx > 0) {
+        int32_t start = std::max(0, input_start);
+        int32_t offset = start - input_start;
+        source->get2ChannelData(start * 4, (input_idx - start) * 4, (uint8_t*)(input + offset));
+    }
+}
+
+/// keeps the filter history and appends the next chunk from the source
+bool ResampledSoundData::read_input() {
+    if (input_len > RESAMPLE_HISTORY) {
+        memmove((uint8_t*) input, (uint8_t*)(input + input_len - RESAMPLE_HISTORY), RESAMPLE_HISTORY * sizeof(Frame));
+        input_start += input_len - RESAMPLE_HISTORY;
+        input_len = RESAMPLE_HISTORY;
+    }
+    int32_t result = source->get2ChannelData((input_start + input_len) * 4, A2DP_RESAMPLE_CHUNK_FRAMES * 4, (uint8_t*)(input + input_len)) / 4;
+    if (result <= 0) {
+        return false;
+    }
+    input_len += result;
+    return true;
+}
+
+int32_t ResampledSoundData::get2ChannelData(int32_t pos, int32_t len, uint8_t *data) {
+    Frame *result_data = (Frame*) data;
+    int32_t frame_count = len / 4;
+    if (pos != next_pos) {
+        seek(pos / 4);
+    }
+
+    int32_t result_len = 0;
+    while (result_len < frame_count) {
+        bool is_available = true;
+        while (is_available && input_idx >= input_start + input_len) {
+            is_available = read_input();
+        }
+        if (!is_available) {
+            break;
+        }
+        // the filter uses the current input frame and the RESAMPLE_HISTORY frames before it
+        const Frame *x = input + (input_idx - input_start);
+        const int16_t *h = coefficients + phase * RESAMPLE_TAPS;
+        int32_t left = 0;
+        int32_t right = 0;
+        for (int32_t k=0; k<RESAMPLE_TAPS; k++){
+            left += h[k] * x[-k].channel1;
+            right += h[k] * x[-k].channel2;
+        }
+        result_data[result_len].channel1 = resample_saturate(left);
+        result_data[result_len].channel2 = resample_saturate(right);
+        result_len++;
+
+        input_idx += step_idx;
+        phase += step_phase;
+        if (phase >= up) {
+            phase -= up;
+            input_idx++;
+        }
+    }
+    next_pos = pos + result_len * 4;
+    return result_len * 4;
+}
+
+int32_t ResampledSoundData::getData(int32_t pos, Frame &frame) {
+    return get2ChannelData(pos * 4, 4, (uint8_t*) &frame) / 4;
+}
+
+void ResampledSoundData::setDataRaw(uint8_t* data, int32_t len) {
+    source->setDataRaw(data, len);
+    next_pos = -1;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include "config.h"
+#include "SoundData.h"
+
+/**
+ * @brief Adapter which converts the sample rate of any other SoundData on the fly, so that clips
+ * can be stored e.g. with 16000 Hz instead of being resampled to 44100 Hz in Audacity.
+ *
+ * We use a fixed point polyphase FIR filter (Kaiser windowed sinc) for the exact ratio output_rate/input_rate.
+ * The coefficient table with A2DP_RESAMPLE_TAPS coefficients per phase is calculated by the first instance of a
+ * ratio and shared by all later ones. It has (output_rate / gcd) phases: e.g. 441 for 8000, 16000 and 32000 Hz,
+ * which share one table of 28 KB with 32 taps.
+ *
+ * With 32 taps the passband is flat (gain > 0.96) up to 0.4 of the lower of the two rates, e.g. 6.4 kHz for
+ * 16000 Hz and 17.6 kHz for 48000 Hz. Above it the tone is attenuated (7 kHz at 16000 Hz by 3.3 dB) but the images
+ * stay below -70 dB. With 16 taps the passband ends at 0.35 of the lower rate and the images of a tone at 0.44 of
+ * it are only 36 dB down.
+ * @copyright Apache License Version 2
+ */
+class ResampledSoundData : public SoundData {
+  public:
+    ResampledSoundData(SoundData *source, uint32_t input_rate, uint32_t output_rate=44100, bool loop=false);
+    ~ResampledSoundData();
+    int32_t get2ChannelData(int32_t pos, int32_t len, uint8_t *data);
+    int32_t getData(int32_t pos, Frame &frame);
+    void setDataRaw(uint8_t* data, int32_t len);
+
+  protected:
+    SoundData *source;
+    int32_t up;     // interpolation factor
+    int32_t down;   // decimation factor
+    int32_t step_idx;
+    int32_t step_phase;
+    const int16_t *coefficients = nullptr;
+    // input frames [input_start, input_start+input_len) which always includes the filter history
+    Frame *input = nullptr;
+    int32_t input_start = 0;
+    int32_t input_len = 0;
+    // input frame and filter phase of the next output frame
+    int32_t input_idx = 0;
+    int32_t phase = 0;
+    int32_t next_pos = -1;
+
+    static const int16_t *setup_coefficients(int32_t up, int32_t down);
+    void seek(int32_t frame);
+    bool read_input();
+};
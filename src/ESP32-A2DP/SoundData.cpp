@@ -13,6 +13,7 @@
 // Copyright 2020 Phil Schatzmann
 
 #include "SoundData.h"
+#include <string.h>
 
 #define SOUND_DATA "SOUND_DATA"
 
@@ -55,10 +56,9 @@ void TwoChannelSoundData::setDataRaw(uint8_t *data, int32_t len){
 
 int32_t TwoChannelSoundData::getData(int32_t pos, int32_t len, Frame *data) {
     //ESP_LOGD(SOUND_DATA, "x%x - pos: %d / len: %d", __func__, pos, len);
-    int result_len = std::min(len, this->len - pos);
-    for (int32_t j=0;j<result_len;j++){
-        data[j] = this->data[pos+j];
-    }
+    int32_t result_len = std::max(0, std::min(len, this->len - pos));
+    // the data is stored in the output format: we can just copy it
+    memcpy(data, this->data + pos, result_len * sizeof(Frame));
     return result_len;
 }
 
@@ -124,18 +124,34 @@ int32_t OneChannelSoundData::getData(int32_t pos, int32_t len, int16_t *data) {
 int32_t OneChannelSoundData::get2ChannelData(int32_t pos, int32_t len, uint8_t *data) {
     //ESP_LOGD(SOUND_DATA, "x%x - pos: %d / len: %d", __func__, pos, len);
     Frame *result_data = (Frame*) data;
-    int32_t frame_count = len / 4;
     int32_t frame_start = pos / 4 ;  
-    int32_t result_len = 0;
-    int32_t frame_pos;
-
-    for (int32_t j=0; j<frame_count; j++){
-        frame_pos = frame_start+j;
-        if (getData(frame_pos, result_data[j]) == 0)
+    int32_t frame_count = std::max(0, std::min(len / 4, this->len - frame_start));
+    const int16_t *source = this->data + frame_start;
+
+    // one loop per channel layout: we do not want to decide this for each frame
+    switch(channelInfo){
+        case Left:
+            for (int32_t j=0; j<frame_count; j++){
+                result_data[j].channel1 = source[j];
+                result_data[j].channel2 = 0;
+            }
+            break;
+        case Right:
+            for (int32_t j=0; j<frame_count; j++){
+                result_data[j].channel1 = 0;
+                result_data[j].channel2 = source[j];
+            }
+            break;
+        case Both:
+        default:
+            for (int32_t j=0; j<frame_count; j++){
+                int16_t sample = source[j];
+                result_data[j].channel1 = sample;
+                result_data[j].channel2 = sample;
+            }
             break;
-        result_len+=4;
     }
-    return result_len;
+    return frame_count * 4;
 }
 
 int32_t OneChannelSoundData::getData(int32_t pos, Frame &frame){
@@ -206,18 +222,34 @@ int32_t OneChannel8BitSoundData::getData(int32_t pos, int32_t len, int8_t *data)
 int32_t OneChannel8BitSoundData::get2ChannelData(int32_t pos, int32_t len, uint8_t *data) {
     //ESP_LOGD(SOUND_DATA, "x%x - pos: %d / len: %d", __func__, pos, len);
     Frame *result_data = (Frame*) data;
-    int32_t frame_count = len / 4;
     int32_t frame_start = pos / 4 ;  
-    int32_t result_len = 0;
-    int32_t frame_pos;
-
-    for (int32_t j=0; j<frame_count; j++){
-        frame_pos = frame_start+j;
-        if (getData(frame_pos, result_data[j]) == 0)
+    int32_t frame_count = std::max(0, std::min(len / 4, this->len - frame_start));
+    const int8_t *source = this->data + frame_start;
+
+    // one loop per channel layout: we do not want to decide this for each frame
+    switch(channelInfo){
+        case Left:
+            for (int32_t j=0; j<frame_count; j++){
+                result_data[j].channel1 = source[j] * 127;
+                result_data[j].channel2 = 0;
+            }
+            break;
+        case Right:
+            for (int32_t j=0; j<frame_count; j++){
+                result_data[j].channel1 = 0;
+                result_data[j].channel2 = source[j] * 127;
+            }
+            break;
+        case Both:
+        default:
+            for (int32_t j=0; j<frame_count; j++){
+                int16_t sample = source[j] * 127;
+                result_data[j].channel1 = sample;
+                result_data[j].channel2 = sample;
+            }
             break;
-        result_len+=4;
     }
-    return result_len;
+    return frame_count * 4;
 }
 
 int32_t OneChannel8BitSoundData::getData(int32_t pos, Frame &frame){
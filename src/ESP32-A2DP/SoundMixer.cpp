@@ -0,0 +1,164 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include "SoundMixer.h"
+#include <string.h>
+
+#define MIXER_UNITY_GAIN 32768
+
+static inline int16_t mixer_saturate(int32_t value) {
+    return value > 32767 ? 32767 : (value < -32768 ? -32768 : value);
+}
+
+/// result = data * gain
+static void mixer_copy(Frame *result, const Frame *data, int32_t len, int32_t gain) {
+    if (gain == MIXER_UNITY_GAIN) {
+        memcpy((uint8_t*) result, (const uint8_t*) data, len * sizeof(Frame));
+        return;
+    }
+    for (int32_t j=0; j<len; j++){
+        result[j].channel1 = mixer_saturate((data[j].channel1 * gain) >> 15);
+        result[j].channel2 = mixer_saturate((data[j].channel2 * gain) >> 15);
+    }
+}
+
+/// result = saturate(result + data * gain)
+static void mixer_add(Frame *result, const Frame *data, int32_t len, int32_t gain) {
+    if (gain == MIXER_UNITY_GAIN) {
+        for (int32_t j=0; j<len; j++){
+            result[j].channel1 = mixer_saturate(result[j].channel1 + data[j].channel1);
+            result[j].channel2 = mixer_saturate(result[j].channel2 + data[j].channel2);
+        }
+        return;
+    }
+    for (int32_t j=0; j<len; j++){
+        result[j].channel1 = mixer_saturate(result[j].channel1 + ((data[j].channel1 * gain) >> 15));
+        result[j].channel2 = mixer_saturate(result[j].channel2 + ((data[j].channel2 * gain) >> 15));
+    }
+}
+
+SoundMixer::SoundMixer() {
+    setLoop(false);
+}
+
+int32_t SoundMixer::to_gain(float gain) {
+    // we support an amplification up to 2: the product of a sample and the gain must fit into 32 bits
+    gain = std::max(0.0f, std::min(2.0f, gain));
+    return (int32_t) (gain * MIXER_UNITY_GAIN + 0.5f);
+}
+
+int SoundMixer::play(SoundData *data, float gain, bool loop) {
+    for (int slot=0; slot<A2DP_MIXER_STREAMS; slot++){
+        uint8_t expected = SLOT_FREE;
+        if (streams[slot].state.compare_exchange_strong(expected, SLOT_CLAIMED)) {
+            // the data callback ignores claimed slots, so we can set them up safely
+            mixer_stream_t &stream = streams[slot];
+            stream.data = data;
+            stream.pos = 0;
+            stream.loop = loop;
+            stream.gain = to_gain(gain);
+            stream.state.store(SLOT_PLAYING, std::memory_order_release);
+            return slot;
+        }
+    }
+    return -1;
+}
+
+void SoundMixer::stop(int slot) {
+    if (slot < 0 || slot >= A2DP_MIXER_STREAMS) {
+        return;
+    }
+    uint8_t expected = SLOT_PLAYING;
+    streams[slot].state.compare_exchange_strong(expected, SLOT_STOPPING);
+}
+
+void SoundMixer::stop_all() {
+    for (int slot=0; slot<A2DP_MIXER_STREAMS; slot++){
+        stop(slot);
+    }
+}
+
+bool SoundMixer::is_playing(int slot) {
+    return slot >= 0 && slot < A2DP_MIXER_STREAMS && streams[slot].state == SLOT_PLAYING;
+}
+
+void SoundMixer::set_gain(int slot, float gain) {
+    if (slot >= 0 && slot < A2DP_MIXER_STREAMS) {
+        streams[slot].gain = to_gain(gain);
+    }
+}
+
+bool SoundMixer::mix_stream(mixer_stream_t &stream, Frame *result, int32_t frame_count, bool is_first) {
+    int32_t gain = stream.gain.load(std::memory_order_relaxed);
+    int32_t done = 0;
+    while (done < frame_count) {
+        int32_t len = std::min(A2DP_MIXER_CHUNK_FRAMES, frame_count - done);
+        int32_t result_len = stream.data->get2ChannelData(stream.pos, len * 4, (uint8_t*) chunk) / 4;
+        if (result_len <= 0) {
+            if (stream.loop && stream.pos > 0) {
+                stream.pos = 0;
+                continue;
+            }
+            // the first stream defines the result, so we need to provide silence for the rest
+            if (is_first) {
+                memset((uint8_t*)(result + done), 0, (frame_count - done) * sizeof(Frame));
+            }
+            return false;
+        }
+        stream.pos += result_len * 4;
+        if (is_first) {
+            mixer_copy(result + done, chunk, result_len, gain);
+        } else {
+            mixer_add(result + done, chunk, result_len, gain);
+        }
+        done += result_len;
+    }
+    return true;
+}
+
+int32_t SoundMixer::get2ChannelData(int32_t pos, int32_t len, uint8_t *data) {
+    Frame *result_data = (Frame*) data;
+    int32_t frame_count = len / 4;
+    bool is_first = true;
+
+    for (int slot=0; slot<A2DP_MIXER_STREAMS; slot++){
+        mixer_stream_t &stream = streams[slot];
+        uint8_t state = stream.state.load(std::memory_order_acquire);
+        if (state == SLOT_STOPPING) {
+            stream.state.store(SLOT_FREE, std::memory_order_release);
+            continue;
+        }
+        if (state != SLOT_PLAYING) {
+            continue;
+        }
+        if (!mix_stream(stream, result_data, frame_count, is_first)) {
+            // end of data: a stop request is obsolete now
+            stream.state.store(SLOT_FREE, std::memory_order_release);
+        }
+        is_first = false;
+    }
+
+    if (is_first) {
+        memset(data, 0, frame_count * sizeof(Frame));
+    }
+    return frame_count * 4;
+}
+
+int32_t SoundMixer::getData(int32_t pos, Frame &frame) {
+    return get2ChannelData(pos * 4, 4, (uint8_t*) &frame) / 4;
+}
+
+void SoundMixer::setDataRaw(uint8_t* data, int32_t len) {
+    // the data is provided by the streams
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include <atomic>
+#include "config.h"
+#include "SoundData.h"
+
+/**
+ * @brief Mixes up to A2DP_MIXER_STREAMS SoundData streams (e.g. a chime on top of a background track).
+ * Each stream has its own position, gain and loop flag. The mixer is a SoundData itself, so it is used
+ * with BluetoothA2DPSource::write_data(&mixer) and provides silence when nothing is playing.
+ *
+ * Streams can be started and stopped from any task: the slots are handed over with atomic state
+ * changes, so the A2DP data callback never waits for a lock.
+ * @copyright Apache License Version 2
+ */
+class SoundMixer : public SoundData {
+  public:
+    SoundMixer();
+    /// starts the data in a free slot: returns the slot or -1 if all slots are in use
+    int play(SoundData *data, float gain=1.0, bool loop=false);
+    /// requests to stop the slot: it is released by the next data callback
+    void stop(int slot);
+    void stop_all();
+    bool is_playing(int slot);
+    /// changes the gain of a playing slot (1.0 = unchanged, at most 2.0)
+    void set_gain(int slot, float gain);
+    int32_t get2ChannelData(int32_t pos, int32_t len, uint8_t *data);
+    int32_t getData(int32_t pos, Frame &frame);
+    void setDataRaw(uint8_t* data, int32_t len);
+
+  protected:
+    enum { SLOT_FREE, SLOT_CLAIMED, SLOT_PLAYING, SLOT_STOPPING };
+
+    struct mixer_stream_t {
+        std::atomic<uint8_t> state{SLOT_FREE};
+        std::atomic<int32_t> gain{0};  // Q15
+        SoundData *data = nullptr;
+        int32_t pos = 0;  // in bytes
+        bool loop = false;
+    };
+
+    mixer_stream_t streams[A2DP_MIXER_STREAMS];
+    Frame chunk[A2DP_MIXER_CHUNK_FRAMES];
+
+    /// adds the next frames of the stream to the result: returns false at the end of the data
+    virtual bool mix_stream(mixer_stream_t &stream, Frame *result, int32_t frame_count, bool is_first);
+    static int32_t to_gain(float gain);
+};
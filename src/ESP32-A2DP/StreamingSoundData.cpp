@@ -0,0 +1,295 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include "StreamingSoundData.h"
+#include <string.h>
+#include "esp_log.h"
+
+#define STREAMING_SOUND_DATA "STREAMING_SOUND_DATA"
+
+//*****************************************************************************************
+//  FileSoundSource
+//*****************************************************************************************
+
+FileSoundSource::FileSoundSource(const char *path) {
+    this->path = path;
+}
+
+FileSoundSource::~FileSoundSource() {
+    close();
+}
+
+bool FileSoundSource::open() {
+    close();
+    file = fopen(path, "rb");
+    if (file == nullptr) {
+        ESP_LOGE(STREAMING_SOUND_DATA, "%s: could not open %s", __func__, path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    file_pos = 0;
+    return true;
+}
+
+void FileSoundSource::close() {
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+int32_t FileSoundSource::size() {
+    return file_size;
+}
+
+int32_t FileSoundSource::read(int32_t pos, uint8_t *data, int32_t len) {
+    if (file == nullptr) {
+        return 0;
+    }
+    // we only need to seek when we loop or restart
+    if (pos != file_pos && fseek(file, pos, SEEK_SET) != 0) {
+        ESP_LOGE(STREAMING_SOUND_DATA, "%s: seek to %d failed", __func__, pos);
+        return 0;
+    }
+    int32_t result = fread(data, 1, len, file);
+    file_pos = pos + result;
+    return result;
+}
+
+//*****************************************************************************************
+//  PartitionSoundSource
+//*****************************************************************************************
+
+PartitionSoundSource::PartitionSoundSource(const char *label, int32_t len) {
+    this->label = label;
+    this->len = len;
+}
+
+bool PartitionSoundSource::open() {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (partition == nullptr) {
+        ESP_LOGE(STREAMING_SOUND_DATA, "%s: partition %s not found", __func__, label);
+        return false;
+    }
+    if (len < 0 || len > (int32_t) partition->size) {
+        len = partition->size;
+    }
+    return true;
+}
+
+int32_t PartitionSoundSource::size() {
+    return partition == nullptr ? 0 : len;
+}
+
+int32_t PartitionSoundSource::read(int32_t pos, uint8_t *data, int32_t len) {
+    int32_t result = std::max(0, std::min(len, size() - pos));
+    if (result > 0 && esp_partition_read(partition, pos, data, result) != ESP_OK) {
+        ESP_LOGE(STREAMING_SOUND_DATA, "%s: read at %d failed", __func__, pos);
+        return 0;
+    }
+    return result;
+}
+
+//*****************************************************************************************
+//  StreamingSoundData
+//*****************************************************************************************
+
+extern "C" void ccall_streaming_sound_data_task(void *param) {
+    ((StreamingSoundData*) param)->refill_task();
+}
+
+StreamingSoundData::StreamingSoundData(StreamingSoundSource *source, bool loop, uint8_t channels, ChannelInfo channelInfo) {
+    this->source = source;
+    this->channels = channels == 1 ? 1 : 2;
+    this->channelInfo = channelInfo;
+    setLoop(loop);
+}
+
+StreamingSoundData::~StreamingSoundData() {
+    end();
+}
+
+bool StreamingSoundData::begin(int32_t buffer_frames) {
+    end();
+    if (!source->open()) {
+        return false;
+    }
+    frame_count = source->size() / (2 * channels);
+    source_pos = 0;
+    next_pos = 0;
+    underrun_count = 0;
+    is_eof = false;
+    restart_state = STREAM_RUNNING;
+    buffer = new FrameRingBuffer(buffer_frames);
+    chunk = new Frame[A2DP_STREAM_CHUNK_FRAMES];
+
+    // fill the cache, so that we can start without underruns
+    while (refill() > 0);
+
+    is_active = true;
+    is_task_running = true;
+    if (xTaskCreate(ccall_streaming_sound_data_task, "StreamT", A2DP_STREAM_TASK_STACK, this, A2DP_STREAM_TASK_PRIORITY, &task_handle) != pdPASS) {
+        ESP_LOGE(STREAMING_SOUND_DATA, "%s: could not create the refill task", __func__);
+        is_active = false;
+        is_task_running = false;
+        end();
+        return false;
+    }
+    ESP_LOGI(STREAMING_SOUND_DATA, "%s: %d frames - %d frames cached", __func__, frame_count, buffer->available());
+    return true;
+}
+
+void StreamingSoundData::end() {
+    if (is_task_running) {
+        is_active = false;
+        xTaskNotifyGive(task_handle);
+        // the task might still be reading from the storage
+        while (is_task_running) {
+            vTaskDelay(pdMS_TO_TICKS(1));
+        }
+        task_handle = nullptr;
+    }
+    if (buffer != nullptr) {
+        source->close();
+        delete buffer;
+        delete[] chunk;
+        buffer = nullptr;
+        chunk = nullptr;
+    }
+}
+
+void StreamingSoundData::refill_task() {
+    while (is_active) {
+        if (restart_state == STREAM_RESTART_REQUESTED) {
+            source_pos = 0;
+            is_eof = false;
+            // the consumer can now discard the old data: we do not write until it has done so
+            restart_state = STREAM_RESTART_CONFIRMED;
+        }
+        if (restart_state != STREAM_RUNNING || refill() == 0) {
+            // wait for the consumer: the timeout makes sure we also recover from a missed notification
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+        }
+    }
+    is_task_running = false;
+    vTaskDelete(nullptr);
+}
+
+int32_t StreamingSoundData::refill() {
+    if (is_eof || buffer->available_for_write() < A2DP_STREAM_CHUNK_FRAMES) {
+        return 0;
+    }
+    if (source_pos >= frame_count) {
+        if (doLoop() && frame_count > 0) {
+            source_pos = 0;
+        } else {
+            is_eof = true;
+            return 0;
+        }
+    }
+
+    int32_t bytes_per_frame = 2 * channels;
+    int32_t len = std::min(A2DP_STREAM_CHUNK_FRAMES, frame_count - source_pos);
+    int32_t result = source->read(source_pos * bytes_per_frame, (uint8_t*) chunk, len * bytes_per_frame) / bytes_per_frame;
+    if (result <= 0) {
+        ESP_LOGE(STREAMING_SOUND_DATA, "%s: read failed at frame %d", __func__, source_pos);
+        is_eof = true;
+        return 0;
+    }
+
+    if (channels == 1) {
+        // expand in place from the end: frame j never overwrites a sample < j
+        int16_t *samples = (int16_t*) chunk;
+        switch(channelInfo){
+            case Left:
+                for (int32_t j=result-1; j>=0; j--){
+                    chunk[j] = Frame(samples[j], 0);
+                }
+                break;
+            case Right:
+                for (int32_t j=result-1; j>=0; j--){
+                    chunk[j] = Frame(0, samples[j]);
+                }
+                break;
+            case Both:
+            default:
+                for (int32_t j=result-1; j>=0; j--){
+                    chunk[j] = Frame(samples[j]);
+                }
+                break;
+        }
+    }
+
+    buffer->write(chunk, result);
+    source_pos += result;
+    return result;
+}
+
+void StreamingSoundData::notify_refill() {
+    if (task_handle != nullptr && buffer->available_for_write() >= A2DP_STREAM_CHUNK_FRAMES) {
+        xTaskNotifyGive(task_handle);
+    }
+}
+
+int32_t StreamingSoundData::get2ChannelData(int32_t pos, int32_t len, uint8_t *data) {
+    if (buffer == nullptr) {
+        return 0;
+    }
+    Frame *result_data = (Frame*) data;
+    int32_t requested = len / 4;
+
+    // we are asked to start from the beginning: e.g. write_data() was called again
+    if (pos == 0 && next_pos != 0 && restart_state == STREAM_RUNNING) {
+        restart_state = STREAM_RESTART_REQUESTED;
+        if (task_handle != nullptr) {
+            xTaskNotifyGive(task_handle);
+        }
+    }
+    if (restart_state == STREAM_RESTART_CONFIRMED) {
+        buffer->clear();
+        next_pos = 0;
+        restart_state = STREAM_RUNNING;
+        notify_refill();
+    }
+    if (restart_state != STREAM_RUNNING) {
+        memset(data, 0, requested * 4);
+        return requested * 4;
+    }
+
+    int32_t result = buffer->read(result_data, requested);
+    notify_refill();
+    if (result < requested) {
+        if (is_eof && buffer->available() == 0) {
+            // end of data: the remaining frames (if any) are the last ones
+            next_pos = pos + result * 4;
+            return result * 4;
+        }
+        // the storage did not keep up: we rather play silence than block the A2DP callback
+        memset((uint8_t*)(result_data + result), 0, (requested - result) * 4);
+        underrun_count++;
+        result = requested;
+    }
+    next_pos = pos + result * 4;
+    return result * 4;
+}
+
+int32_t StreamingSoundData::getData(int32_t pos, Frame &frame) {
+    return get2ChannelData(pos * 4, 4, (uint8_t*) &frame) / 4;
+}
+
+void StreamingSoundData::setDataRaw(uint8_t* data, int32_t len) {
+    ESP_LOGE(STREAMING_SOUND_DATA, "%s: not supported - the data is provided by the StreamingSoundSource", __func__);
+}
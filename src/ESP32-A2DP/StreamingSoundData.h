@@ -0,0 +1,136 @@
+#pragma once
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include <stdio.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_partition.h"
+#include "config.h"
+#include "SoundData.h"
+#include "FrameRingBuffer.h"
+
+extern "C" void ccall_streaming_sound_data_task(void *param);
+
+/**
+ * @brief Storage which provides the raw signed 16 bit PCM data for StreamingSoundData
+ * @copyright Apache License Version 2
+ */
+class StreamingSoundSource {
+  public:
+    virtual ~StreamingSoundSource() {}
+    /// prepares the storage for reading: returns false if it is not available
+    virtual bool open() = 0;
+    virtual void close() {}
+    /// size in bytes
+    virtual int32_t size() = 0;
+    /// reads up to len bytes starting at the byte position pos and returns the number of bytes read
+    virtual int32_t read(int32_t pos, uint8_t *data, int32_t len) = 0;
+};
+
+/**
+ * @brief Raw PCM file in any mounted file system: e.g. "/sdcard/alarm.raw"
+ * @copyright Apache License Version 2
+ */
+class FileSoundSource : public StreamingSoundSource {
+  public:
+    FileSoundSource(const char *path);
+    ~FileSoundSource();
+    bool open();
+    void close();
+    int32_t size();
+    int32_t read(int32_t pos, uint8_t *data, int32_t len);
+
+  protected:
+    const char *path;
+    FILE *file = nullptr;
+    int32_t file_size = 0;
+    int32_t file_pos = 0;
+};
+
+/**
+ * @brief Raw PCM data in a data partition which has been flashed separately from the firmware
+ * e.g. with "esptool.py write_flash <offset> alarm.raw". The size of the data can be provided
+ * when it is smaller than the partition.
+ * @copyright Apache License Version 2
+ */
+class PartitionSoundSource : public StreamingSoundSource {
+  public:
+    PartitionSoundSource(const char *label, int32_t len = -1);
+    bool open();
+    int32_t size();
+    int32_t read(int32_t pos, uint8_t *data, int32_t len);
+
+  protected:
+    const char *label;
+    const esp_partition_t *partition = nullptr;
+    int32_t len;
+};
+
+/**
+ * @brief Sound data which is streamed from a StreamingSoundSource (e.g. a file on a SD card or a flash
+ * partition) instead of being kept in memory. The data has the same format as for TwoChannelSoundData (channels=2)
+ * or OneChannelSoundData (channels=1).
+ *
+ * A background task reads ahead into a ring buffer, so get2ChannelData() never waits for the storage:
+ * if the storage can not keep up we provide silence.
+ * @copyright Apache License Version 2
+ */
+class StreamingSoundData : public SoundData {
+  public:
+    StreamingSoundData(StreamingSoundSource *source, bool loop=false, uint8_t channels=2, ChannelInfo channelInfo=Both);
+    ~StreamingSoundData();
+    /// opens the source, fills the read-ahead cache and starts the refill task
+    bool begin(int32_t buffer_frames=A2DP_STREAM_BUFFER_FRAMES);
+    /// stops the refill task and closes the source
+    void end();
+    int32_t get2ChannelData(int32_t pos, int32_t len, uint8_t *data);
+    int32_t getData(int32_t pos, Frame &frame);
+    void setDataRaw(uint8_t* data, int32_t len);
+    /// number of frames which are available in the read-ahead cache
+    int32_t available() {
+      return buffer == nullptr ? 0 : buffer->available();
+    }
+    /// number of times we needed to provide silence because the cache was empty
+    uint32_t underruns() {
+      return underrun_count;
+    }
+
+  protected:
+    friend void ccall_streaming_sound_data_task(void *param);
+
+    // restart_state: 0 = streaming, 1 = restart requested by the consumer, 2 = restart confirmed by the refill task
+    enum { STREAM_RUNNING, STREAM_RESTART_REQUESTED, STREAM_RESTART_CONFIRMED };
+
+    StreamingSoundSource *source;
+    uint8_t channels;
+    ChannelInfo channelInfo;
+    FrameRingBuffer *buffer = nullptr;
+    Frame *chunk = nullptr;
+    TaskHandle_t task_handle = nullptr;
+    int32_t frame_count = 0;
+    int32_t source_pos = 0;  // in frames: only used by the refill task
+    int32_t next_pos = 0;    // in bytes: only used by the consumer
+    uint32_t underrun_count = 0;
+    std::atomic<bool> is_active{false};
+    std::atomic<bool> is_task_running{false};
+    std::atomic<bool> is_eof{false};
+    std::atomic<uint8_t> restart_state{STREAM_RUNNING};
+
+    virtual void refill_task();
+    virtual int32_t refill();
+    virtual void notify_refill();
+};
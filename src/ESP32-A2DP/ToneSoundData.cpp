@@ -0,0 +1,283 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include "ToneSoundData.h"
+#include <math.h>
+#include <string.h>
+
+#define TONE_TABLE_BITS 8
+#define TONE_TABLE_SIZE (1 << TONE_TABLE_BITS)
+#define TONE_HARMONICS 15
+#define TONE_ENV_MAX (1 << 30)
+#define TONE_CHUNK_FRAMES 128
+
+// one additional entry for the interpolation at the end of the table
+static int16_t tone_sine_table[TONE_TABLE_SIZE + 1];
+static int16_t tone_square_table[TONE_TABLE_SIZE + 1];
+static int16_t tone_saw_table[TONE_TABLE_SIZE + 1];
+static bool tone_tables_valid = false;
+
+/// square and saw are band limited (sum of the first harmonics) to reduce aliasing
+static void tone_setup_tables() {
+    double square[TONE_TABLE_SIZE + 1];
+    double saw[TONE_TABLE_SIZE + 1];
+    double square_max = 0;
+    double saw_max = 0;
+    for (int32_t j=0; j<=TONE_TABLE_SIZE; j++){
+        double x = 2.0 * M_PI * j / TONE_TABLE_SIZE;
+        square[j] = 0;
+        saw[j] = 0;
+        for (int32_t k=1; k<=TONE_HARMONICS; k++){
+            if (k % 2 == 1) {
+                square[j] += sin(k * x) / k;
+            }
+            saw[j] += (k % 2 == 1 ? 1.0 : -1.0) * sin(k * x) / k;
+        }
+        square_max = std::max(square_max, fabs(square[j]));
+        saw_max = std::max(saw_max, fabs(saw[j]));
+    }
+    for (int32_t j=0; j<=TONE_TABLE_SIZE; j++){
+        tone_sine_table[j] = lround(32767.0 * sin(2.0 * M_PI * j / TONE_TABLE_SIZE));
+        tone_square_table[j] = lround(32767.0 * square[j] / square_max);
+        tone_saw_table[j] = lround(32767.0 * saw[j] / saw_max);
+    }
+    tone_tables_valid = true;
+}
+
+static inline int16_t tone_saturate(int32_t value) {
+    return value > 32767 ? 32767 : (value < -32768 ? -32768 : value);
+}
+
+ToneSoundData::ToneSoundData(uint32_t sample_rate) {
+    if (!tone_tables_valid) {
+        tone_setup_tables();
+    }
+    this->sample_rate = sample_rate;
+    setLoop(false);
+}
+
+void ToneSoundData::set_envelope(int voice, tone_envelope_t envelope) {
+    if (voice >= 0 && voice < A2DP_TONE_VOICES) {
+        voices[voice].envelope = envelope;
+    }
+}
+
+void ToneSoundData::note_on(int voice, uint16_t frequency, ToneWaveform waveform, float volume) {
+    if (voice < 0 || voice >= A2DP_TONE_VOICES) {
+        return;
+    }
+    tone_voice_t &v = voices[voice];
+    v.sequence = nullptr;
+    v.table = waveform == ToneSquare ? tone_square_table : (waveform == ToneSaw ? tone_saw_table : tone_sine_table);
+    v.volume = std::max(0, std::min(32767, (int) (volume * 32768)));
+    start_note(v, frequency);
+}
+
+void ToneSoundData::note_off(int voice) {
+    if (voice >= 0 && voice < A2DP_TONE_VOICES) {
+        voices[voice].sequence = nullptr;
+        release_note(voices[voice]);
+    }
+}
+
+void ToneSoundData::play_sequence(int voice, const tone_note_t *notes, int32_t len, ToneWaveform waveform, float volume, bool loop) {
+    if (voice < 0 || voice >= A2DP_TONE_VOICES) {
+        return;
+    }
+    note_on(voice, 0, waveform, volume);
+    tone_voice_t &v = voices[voice];
+    v.sequence = notes;
+    v.sequence_len = len;
+    v.sequence_idx = 0;
+    v.sequence_loop = loop;
+    v.note_samples = 0;
+    v.gate_samples = -1;
+}
+
+void ToneSoundData::stop() {
+    for (int j=0; j<A2DP_TONE_VOICES; j++){
+        voices[j].sequence = nullptr;
+        voices[j].stage = ENV_OFF;
+        voices[j].level = 0;
+    }
+}
+
+bool ToneSoundData::is_active(tone_voice_t &voice) {
+    return voice.stage != ENV_OFF || voice.sequence != nullptr;
+}
+
+bool ToneSoundData::is_active() {
+    for (int j=0; j<A2DP_TONE_VOICES; j++){
+        if (is_active(voices[j])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int32_t ToneSoundData::ms_to_samples(uint32_t ms) {
+    return std::max((int64_t) 1, (int64_t) ms * sample_rate / 1000);
+}
+
+/// a frequency of 0 is a rest
+void ToneSoundData::start_note(tone_voice_t &voice, uint16_t frequency) {
+    if (frequency == 0) {
+        release_note(voice);
+        return;
+    }
+    voice.increment = ((uint64_t) frequency << 32) / sample_rate;
+    voice.sustain_level = TONE_ENV_MAX / 100 * std::min((int) voice.envelope.sustain_percent, 100);
+    voice.attack_step = std::max(1, TONE_ENV_MAX / ms_to_samples(voice.envelope.attack_ms));
+    voice.decay_step = std::max(1, (TONE_ENV_MAX - voice.sustain_level) / ms_to_samples(voice.envelope.decay_ms));
+    // we continue from the current level to avoid clicks
+    voice.stage = ENV_ATTACK;
+}
+
+void ToneSoundData::release_note(tone_voice_t &voice) {
+    if (voice.stage != ENV_OFF && voice.stage != ENV_RELEASE) {
+        voice.release_step = std::max(1, voice.level / ms_to_samples(voice.envelope.release_ms));
+        voice.stage = ENV_RELEASE;
+    }
+}
+
+void ToneSoundData::next_sequence_note(tone_voice_t &voice) {
+    if (voice.sequence_idx >= voice.sequence_len) {
+        if (!voice.sequence_loop || voice.sequence_len == 0) {
+            voice.sequence = nullptr;
+            return;
+        }
+        voice.sequence_idx = 0;
+    }
+    const tone_note_t &note = voice.sequence[voice.sequence_idx++];
+    start_note(voice, note.frequency);
+    voice.note_samples = ms_to_samples(note.duration_ms);
+    // we release a bit before the end, so that repeated notes can be distinguished
+    voice.gate_samples = note.frequency == 0 ? -1 : voice.note_samples - voice.note_samples / 8;
+}
+
+void ToneSoundData::render(tone_voice_t &voice, int32_t *mix, int32_t len) {
+    int32_t j = 0;
+    while (j < len) {
+        int32_t n = len - j;
+        // split up the block at the events of the melody
+        if (voice.sequence != nullptr) {
+            if (voice.note_samples <= 0) {
+                next_sequence_note(voice);
+                continue;
+            }
+            if (voice.gate_samples == 0) {
+                release_note(voice);
+                voice.gate_samples = -1;
+            }
+            n = std::min(n, voice.note_samples);
+            if (voice.gate_samples > 0) {
+                n = std::min(n, voice.gate_samples);
+            }
+            voice.note_samples -= n;
+            if (voice.gate_samples > 0) {
+                voice.gate_samples -= n;
+            }
+        } else if (voice.stage == ENV_OFF) {
+            return;
+        }
+
+        int32_t *result = mix + j;
+        j += n;
+        if (voice.stage == ENV_OFF) {
+            // e.g. a rest
+            voice.phase += voice.increment * n;
+            continue;
+        }
+
+        const int16_t *table = voice.table;
+        uint32_t phase = voice.phase;
+        uint32_t increment = voice.increment;
+        if (voice.stage == ENV_SUSTAIN) {
+            // constant gain
+            int32_t gain = ((voice.level >> 15) * voice.volume) >> 15;
+            for (int32_t k=0; k<n; k++){
+                uint32_t idx = phase >> (32 - TONE_TABLE_BITS);
+                int32_t frac = (phase >> (32 - TONE_TABLE_BITS - 15)) & 0x7FFF;
+                int32_t sample = table[idx] + (((table[idx + 1] - table[idx]) * frac) >> 15);
+                result[k] += (sample * gain) >> 15;
+                phase += increment;
+            }
+        } else {
+            for (int32_t k=0; k<n && voice.stage != ENV_OFF; k++){
+                switch(voice.stage){
+                    case ENV_ATTACK:
+                        voice.level += voice.attack_step;
+                        if (voice.level >= TONE_ENV_MAX) {
+                            voice.level = TONE_ENV_MAX;
+                            voice.stage = ENV_DECAY;
+                        }
+                        break;
+                    case ENV_DECAY:
+                        voice.level -= voice.decay_step;
+                        if (voice.level <= voice.sustain_level) {
+                            voice.level = voice.sustain_level;
+                            voice.stage = voice.sustain_level > 0 ? ENV_SUSTAIN : ENV_OFF;
+                        }
+                        break;
+                    case ENV_RELEASE:
+                        voice.level -= voice.release_step;
+                        if (voice.level <= 0) {
+                            voice.level = 0;
+                            voice.stage = ENV_OFF;
+                        }
+                        break;
+                }
+                uint32_t idx = phase >> (32 - TONE_TABLE_BITS);
+                int32_t frac = (phase >> (32 - TONE_TABLE_BITS - 15)) & 0x7FFF;
+                int32_t sample = table[idx] + (((table[idx + 1] - table[idx]) * frac) >> 15);
+                int32_t gain = ((voice.level >> 15) * voice.volume) >> 15;
+                result[k] += (sample * gain) >> 15;
+                phase += increment;
+            }
+        }
+        voice.phase = phase;
+    }
+}
+
+int32_t ToneSoundData::get2ChannelData(int32_t pos, int32_t len, uint8_t *data) {
+    if (!is_active()) {
+        return 0;
+    }
+    Frame *result_data = (Frame*) data;
+    int32_t frame_count = len / 4;
+    int32_t mix[TONE_CHUNK_FRAMES];
+    for (int32_t done=0; done<frame_count; done+=TONE_CHUNK_FRAMES){
+        int32_t n = std::min(TONE_CHUNK_FRAMES, frame_count - done);
+        memset(mix, 0, n * sizeof(int32_t));
+        for (int j=0; j<A2DP_TONE_VOICES; j++){
+            if (is_active(voices[j])) {
+                render(voices[j], mix, n);
+            }
+        }
+        for (int32_t k=0; k<n; k++){
+            int16_t sample = tone_saturate(mix[k]);
+            result_data[done + k].channel1 = sample;
+            result_data[done + k].channel2 = sample;
+        }
+    }
+    return frame_count * 4;
+}
+
+int32_t ToneSoundData::getData(int32_t pos, Frame &frame) {
+    return get2ChannelData(pos * 4, 4, (uint8_t*) &frame) / 4;
+}
+
+void ToneSoundData::setDataRaw(uint8_t* data, int32_t len) {
+    // the data is synthesized
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Copyright 2020 Phil Schatzmann
+
+#include "config.h"
+#include "SoundData.h"
+
+/**
+ * @brief Waveforms of ToneSoundData
+ */
+enum ToneWaveform {
+    ToneSine,
+    ToneSquare,
+    ToneSaw
+};
+
+/**
+ * @brief A note of a melody: a frequency of 0 is a rest
+ */
+struct tone_note_t {
+    uint16_t frequency;    // Hz
+    uint16_t duration_ms;
+};
+
+/**
+ * @brief ADSR envelope of a voice
+ */
+struct tone_envelope_t {
+    uint16_t attack_ms;
+    uint16_t decay_ms;
+    uint8_t sustain_percent;
+    uint16_t release_ms;
+};
+
+/**
+ * @brief Synthesized sound: a bank of A2DP_TONE_VOICES direct digital synthesis oscillators with
+ * sine, square or saw wavetables and ADSR envelopes. Everything is calculated in fixed point.
+ *
+ * A voice is either controlled with note_on() / note_off() or plays a melody which is provided as
+ * an array of tone_note_t. The data ends when all voices are silent and all melodies are done, so it
+ * can be used with BluetoothA2DPSource::write_data() or SoundMixer::play(). The voices should be set up
+ * before the data is handed over.
+ * @copyright Apache License Version 2
+ */
+class ToneSoundData : public SoundData {
+  public:
+    ToneSoundData(uint32_t sample_rate=44100);
+    void set_envelope(int voice, tone_envelope_t envelope);
+    void note_on(int voice, uint16_t frequency, ToneWaveform waveform=ToneSine, float volume=0.5);
+    void note_off(int voice);
+    /// plays the notes one after the other: the notes are not copied
+    void play_sequence(int voice, const tone_note_t *notes, int32_t len, ToneWaveform waveform=ToneSine, float volume=0.5, bool loop=false);
+    /// stops all voices immediately
+    void stop();
+    /// true as long as any voice is sounding or a melody is playing
+    bool is_active();
+    int32_t get2ChannelData(int32_t pos, int32_t len, uint8_t *data);
+    int32_t getData(int32_t pos, Frame &frame);
+    void setDataRaw(uint8_t* data, int32_t len);
+
+  protected:
+    enum { ENV_OFF, ENV_ATTACK, ENV_DECAY, ENV_SUSTAIN, ENV_RELEASE };
+
+    struct tone_voice_t {
+        // oscillator
+        uint32_t phase = 0;
+        uint32_t increment = 0;
+        const int16_t *table = nullptr;
+        int32_t volume = 0;  // Q15
+        // envelope: the level is in Q30
+        tone_envelope_t envelope = {5, 50, 70, 50};
+        uint8_t stage = ENV_OFF;
+        int32_t level = 0;
+        int32_t attack_step = 0;
+        int32_t decay_step = 0;
+        int32_t sustain_level = 0;
+        int32_t release_step = 0;
+        // melody
+        const tone_note_t *sequence = nullptr;
+        int32_t sequence_len = 0;
+        int32_t sequence_idx = 0;
+        bool sequence_loop = false;
+        int32_t note_samples = 0;  // until the next note
+        int32_t gate_samples = 0;  // until the note_off of the current note
+    };
+
+    uint32_t sample_rate;
+    tone_voice_t voices[A2DP_TONE_VOICES];
+
+    int32_t ms_to_samples(uint32_t ms);
+    void start_note(tone_voice_t &voice, uint16_t frequency);
+    void release_note(tone_voice_t &voice);
+    void next_sequence_note(tone_voice_t &voice);
+    bool is_active(tone_voice_t &voice);
+    /// adds len samples of the voice to the mix
+    void render(tone_voice_t &voice, int32_t *mix, int32_t len);
+};
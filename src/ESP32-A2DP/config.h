@@ -11,6 +11,96 @@
 #define AUTOCONNECT_TRY_NUM 1000
 #endif
 
+// max number of devices which are considered in a ranked inquiry window
+#ifndef A2DP_DISCOVERY_MAX_CANDIDATES
+#define A2DP_DISCOVERY_MAX_CANDIDATES 8
+#endif
+
+// rssi bonus (in dBm) for devices which we have been connected to before
+#ifndef A2DP_KNOWN_DEVICE_RSSI_BONUS
+#define A2DP_KNOWN_DEVICE_RSSI_BONUS 20
+#endif
+
+// max number of sinks which are remembered by the source
+#ifndef A2DP_KNOWN_DEVICES_MAX
+#define A2DP_KNOWN_DEVICES_MAX 4
+#endif
+
+// default capacity (in frames) of the buffer which is used by BluetoothA2DPSource::write_pcm
+#ifndef A2DP_PCM_BUFFER_FRAMES
+#define A2DP_PCM_BUFFER_FRAMES 4096
+#endif
+
+// heart beat of the source: fast while connecting or starting the media, slow otherwise. This is the interval of the
+// checks on the state, not a bound on the time from the connection to the first audio (see get_connect_stats())
+#ifndef A2DP_HEART_BEAT_FAST_MS
+#define A2DP_HEART_BEAT_FAST_MS 200
+#endif
+
+#ifndef A2DP_HEART_BEAT_IDLE_MS
+#define A2DP_HEART_BEAT_IDLE_MS 10000
+#endif
+
+// the source gives up a connection attempt after this time
+#ifndef A2DP_CONNECT_TIMEOUT_MS
+#define A2DP_CONNECT_TIMEOUT_MS 50000
+#endif
+
+// max number of sources which are remembered by the sink for reconnecting
+#ifndef A2DP_RECONNECT_HISTORY_MAX
+#define A2DP_RECONNECT_HISTORY_MAX 4
+#endif
+
+// backoff of the reconnect scheduler of the sink: the delay doubles after each round through the history
+#ifndef A2DP_RECONNECT_DELAY_MIN_MS
+#define A2DP_RECONNECT_DELAY_MIN_MS 500
+#endif
+
+#ifndef A2DP_RECONNECT_DELAY_MAX_MS
+#define A2DP_RECONNECT_DELAY_MAX_MS 30000
+#endif
+
+// read-ahead cache of StreamingSoundData (in frames) and the size of a single read from the storage
+#ifndef A2DP_STREAM_BUFFER_FRAMES
+#define A2DP_STREAM_BUFFER_FRAMES 4096
+#endif
+
+#ifndef A2DP_STREAM_CHUNK_FRAMES
+#define A2DP_STREAM_CHUNK_FRAMES 512
+#endif
+
+// refill task of StreamingSoundData
+#ifndef A2DP_STREAM_TASK_STACK
+#define A2DP_STREAM_TASK_STACK 4096
+#endif
+
+#ifndef A2DP_STREAM_TASK_PRIORITY
+#define A2DP_STREAM_TASK_PRIORITY (configMAX_PRIORITIES - 4)
+#endif
+
+// taps per phase of the polyphase filter of ResampledSoundData and the number of input frames which are read at once
+#ifndef A2DP_RESAMPLE_TAPS
+#define A2DP_RESAMPLE_TAPS 32
+#endif
+
+#ifndef A2DP_RESAMPLE_CHUNK_FRAMES
+#define A2DP_RESAMPLE_CHUNK_FRAMES 128
+#endif
+
+// number of streams which can be played at the same time by SoundMixer and the frames which are mixed at once
+#ifndef A2DP_MIXER_STREAMS
+#define A2DP_MIXER_STREAMS 4
+#endif
+
+#ifndef A2DP_MIXER_CHUNK_FRAMES
+#define A2DP_MIXER_CHUNK_FRAMES 128
+#endif
+
+// number of voices of ToneSoundData
+#ifndef A2DP_TONE_VOICES
+#define A2DP_TONE_VOICES 4
+#endif
+
 // Enable CURRENT_ESP_IDF if we are using a current version of ESP IDF e.g. 4.3
 // ESP Arduino 2.0 is using ESP IDF 4.4
 #if ESP_IDF_VERSION_MAJOR >= 4 || ESP_ARDUINO_VERSION_MAJOR >= 2
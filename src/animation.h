@@ -0,0 +1,95 @@
+#include "Arduino.h"
+
+/*
+  ANIMATIONS
+
+  An animation has a palette of up to 256 RGB565 colors and frames which are runs over the pixels (row by row):
+  0x00 + n - 1, index -> n pixels of palette[index]
+  0x80 + n - 1        -> n pixels stay as in the previous frame
+  The first frame has no pixels to keep. The animations are generated from GIFs by img/golang_img_to_neomatrix.
+
+  AnimationPlayer decodes the frames straight into the matrix: the matrix itself holds the previous frame, so only
+  the pixels which change are written and nothing is allocated.
+*/
+
+struct animation {
+  uint8_t width;
+  uint8_t height;
+  uint8_t frameCount;
+  uint16_t frameDuration; // ms
+  const uint16_t *palette;
+  const uint16_t *frames; // offset of each frame in data
+  const uint8_t *data;
+};
+
+class AnimationPlayer {
+  public:
+    AnimationPlayer(const animation &anim, int16_t x = 0, int16_t y = 0) : anim(anim), x(x), y(y) {}
+
+    // the pixels of the animation have been overwritten: the next draw() decodes the frame from the first frame on
+    void invalidate() {
+      shownFrame = -1;
+    }
+
+    // draws the frame which belongs to the time now
+    void draw(unsigned long now) {
+      int frame = (now / anim.frameDuration) % anim.frameCount;
+      if (frame == shownFrame) {
+        return;
+      }
+
+      // every frame is based on the previous one
+      int first = (shownFrame < 0 || frame < shownFrame) ? 0 : shownFrame + 1;
+      for (int i = first; i <= frame; i++) {
+        decodeFrame(i);
+      }
+      shownFrame = frame;
+    }
+
+  private:
+    const animation &anim;
+    int16_t x;
+    int16_t y;
+    int shownFrame = -1;
+
+    void decodeFrame(int frame) {
+      const uint8_t *data = anim.data + anim.frames[frame];
+      int size = anim.width * anim.height;
+
+      for (int pos = 0; pos < size;) {
+        uint8_t run = *data++;
+        int length = (run & 0x7F) + 1;
+        if (run & 0x80) {
+          pos += length;
+          continue;
+        }
+
+        uint16_t color = anim.palette[*data++];
+        for (int end = min(pos + length, size); pos < end; pos++) {
+          ledMap.pixel(x + pos % anim.width, y + pos / anim.width, color);
+        }
+      }
+    }
+};
+
+// beating heart of the love you screen
+constexpr uint16_t heartPalette[3] = {
+  0x0000, 0xFBD1, 0xF805
+};
+constexpr uint16_t heartFrames[8] = {
+  0, 46, 47, 84, 127, 164, 165, 166
+};
+constexpr uint8_t heartData[167] = {
+  0x00, 0x00, 0x00, 0x01, 0x00, 0x02, 0x01, 0x00, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x02,
+  0x00, 0x01, 0x02, 0x02, 0x00, 0x01, 0x02, 0x02, 0x00, 0x01, 0x02, 0x02, 0x00, 0x01, 0x09, 0x02,
+  0x00, 0x00, 0x05, 0x02, 0x02, 0x00, 0x03, 0x02, 0x04, 0x00, 0x01, 0x02, 0x0A, 0x00, 0xBF, 0x80,
+  0x01, 0x00, 0x81, 0x01, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x00, 0x80, 0x02, 0x00, 0x85, 0x01,
+  0x00, 0x85, 0x00, 0x00, 0x80, 0x00, 0x00, 0x83, 0x00, 0x00, 0x82, 0x00, 0x00, 0x81, 0x00, 0x00,
+  0x84, 0x01, 0x00, 0x8A, 0x80, 0x00, 0x01, 0x00, 0x02, 0x81, 0x00, 0x01, 0x00, 0x02, 0x80, 0x00,
+  0x02, 0x00, 0x01, 0x80, 0x01, 0x02, 0x80, 0x02, 0x02, 0x85, 0x01, 0x02, 0x85, 0x00, 0x02, 0x80,
+  0x00, 0x02, 0x83, 0x00, 0x02, 0x82, 0x00, 0x02, 0x81, 0x00, 0x02, 0x84, 0x01, 0x02, 0x8A, 0x80,
+  0x01, 0x00, 0x81, 0x01, 0x00, 0x80, 0x01, 0x00, 0x80, 0x01, 0x00, 0x80, 0x02, 0x00, 0x85, 0x01,
+  0x00, 0x85, 0x00, 0x00, 0x80, 0x00, 0x00, 0x83, 0x00, 0x00, 0x82, 0x00, 0x00, 0x81, 0x00, 0x00,
+  0x84, 0x01, 0x00, 0x8A, 0xBF, 0xBF, 0xBF
+};
+const animation heart = { 8, 8, 8, 100, heartPalette, heartFrames, heartData };
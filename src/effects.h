@@ -0,0 +1,179 @@
+#include "Arduino.h"
+
+/*
+  EFFECTS
+
+  Full screen effects with integer math only: the colors come from lookup tables which are computed once in
+  begin() and the pixels are written through ledMap, which applies the gamma correction with its own tables.
+
+  An effect draws column by column. EffectRunner stops drawing when the budget of the effect for this frame is used
+  up and continues with the next column in the following frame, so an effect can never hold up the frame rate.
+*/
+
+#define EFFECT_DURATION 15000 // ms per effect on the effects screen
+#define RAINBOW_STEP_TIME 10 // ms per step of the rainbow hue (1/256 of the circle)
+
+struct effect {
+  const char *name;
+  unsigned long budget;                 // us per frame
+  void (*frame)(unsigned long now);     // optional: updates the state once per frame
+  void (*column)(int x, unsigned long now);
+};
+
+// lookup tables
+uint16_t hueTable[256];   // RGB565, full saturation
+uint16_t heatTable[256];  // RGB565, black -> red -> yellow -> white
+uint8_t sineTable[256];   // 128 + 127 * sin(2 pi i / 256)
+
+uint32_t effectRandomState = 1;
+
+// xorshift: cheap and good enough for sparks
+uint8_t effectRandom() {
+  effectRandomState ^= effectRandomState << 13;
+  effectRandomState ^= effectRandomState >> 17;
+  effectRandomState ^= effectRandomState << 5;
+  return effectRandomState;
+}
+
+// RAINBOW: like matrix.rainbow(), the hue runs once along the strip
+void rainbowColumn(int x, unsigned long now) {
+  uint8_t firstHue = now / RAINBOW_STEP_TIME;
+  for (int y = 0; y < MATRIX_HEIGHT; y++) {
+    uint16_t led = ledMapTable::map[y * MATRIX_WIDTH + x];
+    ledMap.pixel(x, y, hueTable[(uint8_t)(firstHue + led * 256 / (MATRIX_WIDTH * MATRIX_HEIGHT))]);
+  }
+}
+
+// PLASMA: sum of three moving sine waves
+void plasmaColumn(int x, unsigned long now) {
+  uint8_t t = now / 16;
+  for (int y = 0; y < MATRIX_HEIGHT; y++) {
+    int value = sineTable[(uint8_t)(x * 16 + t)]
+      + sineTable[(uint8_t)(y * 32 + 2 * t)]
+      + sineTable[(uint8_t)((x + y) * 8 - 3 * t)];
+    ledMap.pixel(x, y, hueTable[(uint8_t)(value / 3 + t)]);
+  }
+}
+
+// FIRE: heat rises from the bottom row and cools down on the way up
+#define FIRE_COOLING 40
+#define FIRE_SPARKS 140 // chance of a spark out of 256
+
+uint8_t fireHeat[MATRIX_WIDTH][MATRIX_HEIGHT];
+
+void fireFrame(unsigned long now) {
+  for (int x = 0; x < MATRIX_WIDTH; x++) {
+    uint8_t *heat = fireHeat[x];
+    for (int y = 0; y < MATRIX_HEIGHT - 1; y++) {
+      int below = heat[y + 1];
+      int twoBelow = heat[min(y + 2, MATRIX_HEIGHT - 1)];
+      int value = (2 * below + twoBelow) / 3 - effectRandom() % FIRE_COOLING;
+      heat[y] = max(value, 0);
+    }
+    if (effectRandom() < FIRE_SPARKS) {
+      heat[MATRIX_HEIGHT - 1] = min(heat[MATRIX_HEIGHT - 1] + 160 + effectRandom() % 96, 255);
+    } else {
+      heat[MATRIX_HEIGHT - 1] = heat[MATRIX_HEIGHT - 1] / 2;
+    }
+  }
+}
+
+void fireColumn(int x, unsigned long now) {
+  for (int y = 0; y < MATRIX_HEIGHT; y++) {
+    ledMap.pixel(x, y, heatTable[fireHeat[x][y]]);
+  }
+}
+
+// RAIN: a drop with a fading trail falls down every column, speed and start depend on the column
+#define RAIN_TRAIL 4
+
+void rainColumn(int x, unsigned long now) {
+  uint8_t seed = sineTable[(uint8_t)(x * 73)];
+  unsigned long position = (now * (6 + seed % 10) / 1000 + seed) % (MATRIX_HEIGHT + RAIN_TRAIL);
+  for (int y = 0; y < MATRIX_HEIGHT; y++) {
+    int distance = (int)position - y;
+    uint16_t color = 0;
+    if (distance >= 0 && distance < RAIN_TRAIL) {
+      uint8_t level = 255 >> distance; // the head is the brightest
+      color = matrix.Color(level / 4, level, level / 2);
+    }
+    ledMap.pixel(x, y, color);
+  }
+}
+
+const effect effects[] = {
+  { "rainbow", 3000, NULL, rainbowColumn },
+  { "plasma", 3000, NULL, plasmaColumn },
+  { "fire", 3000, fireFrame, fireColumn },
+  { "rain", 3000, NULL, rainColumn }
+};
+const int numberOfEffects = sizeof(effects) / sizeof(effects[0]);
+
+class EffectRunner {
+  public:
+    // computes the lookup tables
+    void begin() {
+      for (int i = 0; i < 256; i++) {
+        // hue: six ramps of 43 steps between the primary and secondary colors
+        int sector = i / 43;
+        int ramp = (i % 43) * 255 / 42;
+        int r, g, b;
+        switch (sector) {
+          case 0:  r = 255;        g = ramp;       b = 0;          break;
+          case 1:  r = 255 - ramp; g = 255;        b = 0;          break;
+          case 2:  r = 0;          g = 255;        b = ramp;       break;
+          case 3:  r = 0;          g = 255 - ramp; b = 255;        break;
+          case 4:  r = ramp;       g = 0;          b = 255;        break;
+          default: r = 255;        g = 0;          b = 255 - ramp; break;
+        }
+        hueTable[i] = matrix.Color(r, g, b);
+
+        // heat: red first, then yellow, then white
+        heatTable[i] = matrix.Color(min(3 * i, 255), constrain(3 * i - 255, 0, 255), constrain(3 * i - 510, 0, 255));
+
+        sineTable[i] = 128 + lround(127 * sin(2 * PI * i / 256));
+      }
+    }
+
+    void setEffect(int number) {
+      current = &effects[number % numberOfEffects];
+      nextColumn = 0;
+    }
+
+    const effect &getEffect() { return *current; }
+
+    // draws the effect until its budget is used up, a frame which is not complete is continued next time
+    void draw(unsigned long now) {
+      unsigned long start = micros();
+      if (nextColumn == 0) {
+        frameNow = now;
+        if (current->frame != NULL) {
+          current->frame(frameNow);
+        }
+      }
+
+      while (nextColumn < MATRIX_WIDTH) {
+        current->column(nextColumn++, frameNow);
+        if (nextColumn < MATRIX_WIDTH && micros() - start > current->budget) {
+          overrunCount++;
+          break;
+        }
+      }
+      if (nextColumn == MATRIX_WIDTH) {
+        nextColumn = 0;
+      }
+      lastDrawTime = micros() - start;
+    }
+
+    uint32_t overruns() { return overrunCount; } // frames which have been split because of the budget
+    unsigned long drawTime() { return lastDrawTime; } // us
+
+  private:
+    const effect *current = &effects[0];
+    int nextColumn = 0;
+    unsigned long frameNow = 0;
+    uint32_t overrunCount = 0;
+    unsigned long lastDrawTime = 0;
+};
+
+EffectRunner effectRunner;
@@ -0,0 +1,165 @@
+#include "Arduino.h"
+#include <atomic>
+
+/*
+  FRAME BUFFER
+
+  The screens only draw into the pixels of the matrix and never call matrix.show() themselves. present() runs once
+  per frame and sends the pixels through the LED output only when they differ from the last frame which has been
+  sent, so a static screen costs nothing after its first frame.
+
+  With FRAME_PIPELINE the frames are sent by a task on core 1, so core 0 draws the next frame while the last one goes
+  out. There are three copies of a frame: present() fills the back buffer, the sender task owns the front buffer and
+  the ready slot sits in between. Both sides hand over a buffer by swapping its index with the one in the ready slot
+  in a single atomic exchange, so neither side ever waits for the other. A frame which has not been picked up when
+  the next one is ready is dropped. The sender task counts its shows under statsMux, which report() reads on core 0.
+*/
+
+#ifndef FRAME_PIPELINE
+#define FRAME_PIPELINE true // send the frames from a task on core 1
+#endif
+#define FRAME_READY 0x80 // flag in the ready slot: its buffer holds a frame which has not been sent
+
+class FrameBuffer {
+  public:
+    FrameBuffer(Adafruit_NeoPixel &strip) : strip(strip) {}
+
+    void begin(LedOutput &ledOutput) {
+      output = &ledOutput;
+      size = strip.numPixels() * 3;
+      lastFrame = new uint8_t[size];
+      invalidate();
+      reportStart = millis();
+
+      if (FRAME_PIPELINE) {
+        for (int i = 0; i < 3; i++) {
+          buffers[i] = new uint8_t[size];
+        }
+        xTaskCreatePinnedToCore(senderTask, "FrameSender", 4096, this, 2, &sender, 1);
+      }
+    }
+
+    // the next present() sends the pixels in any case
+    void invalidate() {
+      isValid = false;
+    }
+
+    // sends the frame if it has changed: returns false if it has been skipped
+    bool present() {
+      const uint8_t *pixels = strip.getPixels();
+      bool changed = !isValid || memcmp(pixels, lastFrame, size) != 0;
+
+      if (changed) {
+        unsigned long start = micros();
+        if (sender != NULL) {
+          // hand the frame over to the sender task
+          memcpy(buffers[back], pixels, size);
+          uint8_t previous = ready.exchange(back | FRAME_READY);
+          if (previous & FRAME_READY) {
+            droppedCount++;
+          }
+          back = previous & ~FRAME_READY;
+          xTaskNotifyGive(sender);
+          handoffTime += micros() - start;
+          handoffCount++;
+        } else {
+          output->show(pixels, size);
+          countShow(micros() - start);
+        }
+        memcpy(lastFrame, pixels, size);
+        isValid = true;
+      } else {
+        skippedCount++;
+      }
+
+      report();
+      return changed;
+    }
+
+    // sends the frame in the ready slot if there is one: the loop of the sender task
+    void sendReady() {
+      if (!(ready.load() & FRAME_READY)) {
+        return;
+      }
+      front = ready.exchange(front) & ~FRAME_READY;
+      unsigned long start = micros();
+      output->show(buffers[front], size);
+      countShow(micros() - start);
+    }
+
+    uint32_t shows() {
+      portENTER_CRITICAL(&statsMux);
+      uint32_t count = showCount;
+      portEXIT_CRITICAL(&statsMux);
+      return count;
+    }
+
+    uint32_t skippedShows() { return skippedCount; }
+    uint32_t droppedFrames() { return droppedCount; }
+
+    // average time of a show() in us: until the output has taken the frame, not until the LEDs have it
+    unsigned long averageShowTime() {
+      portENTER_CRITICAL(&statsMux);
+      unsigned long average = showCount == 0 ? 0 : showTime / showCount;
+      portEXIT_CRITICAL(&statsMux);
+      return average;
+    }
+
+  private:
+    Adafruit_NeoPixel &strip;
+    LedOutput *output = NULL;
+    uint8_t *lastFrame = NULL; // pixels of the last show()
+    size_t size = 0;
+    bool isValid = false;
+    portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED; // showCount and showTime, written by the sender task
+    uint32_t showCount = 0;
+    uint32_t skippedCount = 0;
+    uint64_t showTime = 0;
+    unsigned long reportStart = 0;
+    uint32_t lastShowCount = 0; // at the last report
+
+    TaskHandle_t sender = NULL;
+    uint8_t *buffers[3];
+    uint8_t back = 0; // buffer of present()
+    uint8_t front = 1; // buffer of the sender task
+    std::atomic<uint8_t> ready = { 2 }; // buffer in between, with FRAME_READY
+    uint32_t handoffCount = 0;
+    uint32_t droppedCount = 0;
+    uint64_t handoffTime = 0;
+
+    static void senderTask(void *parameter) {
+      FrameBuffer *frameBuffer = (FrameBuffer *)parameter;
+      while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        frameBuffer->sendReady();
+      }
+    }
+
+    void countShow(unsigned long time) {
+      portENTER_CRITICAL(&statsMux);
+      showTime += time;
+      showCount++;
+      portEXIT_CRITICAL(&statsMux);
+    }
+
+    void report() {
+      if (FRAME_REPORT_INTERVAL == 0 || millis() - reportStart < FRAME_REPORT_INTERVAL) {
+        return;
+      }
+      unsigned long interval = millis() - reportStart;
+      uint32_t count = shows();
+      unsigned long average = averageShowTime();
+      // every skipped frame saves one show()
+      Serial.printf("shows: %u (%.1f per s) skipped: %u show time: %lu us saved: %lu ms\n",
+        count, (count - lastShowCount) * 1000.0 / interval, skippedCount, average,
+        (unsigned long)((uint64_t)skippedCount * average / 1000));
+      if (sender != NULL) {
+        Serial.printf("pipeline: handoff time: %lu us dropped: %u\n",
+          handoffCount == 0 ? 0 : (unsigned long)(handoffTime / handoffCount), droppedCount);
+      }
+      lastShowCount = count;
+      reportStart = millis();
+    }
+};
+
+FrameBuffer frameBuffer(matrix);
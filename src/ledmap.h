@@ -0,0 +1,138 @@
+#include "Arduino.h"
+
+/*
+  LED MAP
+
+  Adafruit_NeoMatrix works out the serpentine layout of the panel with branches for every pixel it draws. ledMapTable
+  holds the LED index of every x, y instead, generated at compile time from MATRIX_LAYOUT with the same rules as
+  Adafruit_NeoMatrix. LedMap draws straight into the pixels of the strip through it, with the same colors as the
+  matrix: RGB565 with the gamma correction of Adafruit_NeoMatrix, scaled by the brightness.
+*/
+
+// LED index of x, y (without the rotation of Adafruit_GFX)
+constexpr bool ledColumns() { return (MATRIX_LAYOUT & NEO_MATRIX_AXIS) == NEO_MATRIX_COLUMNS; }
+constexpr int ledFlipX(int x) { return (MATRIX_LAYOUT & NEO_MATRIX_RIGHT) ? MATRIX_WIDTH - 1 - x : x; }
+constexpr int ledFlipY(int y) { return (MATRIX_LAYOUT & NEO_MATRIX_BOTTOM) ? MATRIX_HEIGHT - 1 - y : y; }
+constexpr int ledMajor(int x, int y) { return ledColumns() ? ledFlipX(x) : ledFlipY(y); }
+constexpr int ledMinor(int x, int y) { return ledColumns() ? ledFlipY(y) : ledFlipX(x); }
+constexpr int ledMajorScale() { return ledColumns() ? MATRIX_HEIGHT : MATRIX_WIDTH; }
+
+constexpr uint16_t ledIndex(int x, int y) {
+  // zigzag: every second line runs backwards
+  return ((MATRIX_LAYOUT & NEO_MATRIX_SEQUENCE) == NEO_MATRIX_ZIGZAG && (ledMajor(x, y) & 1))
+    ? (ledMajor(x, y) + 1) * ledMajorScale() - 1 - ledMinor(x, y)
+    : ledMajor(x, y) * ledMajorScale() + ledMinor(x, y);
+}
+
+// the table is generated by expanding the indices 0..MATRIX_WIDTH * MATRIX_HEIGHT - 1 (index = y * width + x)
+template <int... I> struct ledIndices {};
+template <int N, int... I> struct makeLedIndices : makeLedIndices<N - 1, N - 1, I...> {};
+template <int... I> struct makeLedIndices<0, I...> { typedef ledIndices<I...> type; };
+
+template <typename T> struct ledTable;
+template <int... I> struct ledTable<ledIndices<I...>> {
+  static constexpr uint16_t map[sizeof...(I)] = { ledIndex(I % MATRIX_WIDTH, I / MATRIX_WIDTH)... };
+};
+template <int... I> constexpr uint16_t ledTable<ledIndices<I...>>::map[sizeof...(I)];
+
+typedef ledTable<makeLedIndices<MATRIX_WIDTH * MATRIX_HEIGHT>::type> ledMapTable;
+
+static_assert(ledIndex(MATRIX_WIDTH - 1, MATRIX_HEIGHT - 1) == 0, "the first LED is at the bottom right");
+static_assert(ledMapTable::map[MATRIX_WIDTH * MATRIX_HEIGHT - 1] == 0, "the table follows ledIndex()");
+
+class LedMap {
+  public:
+    LedMap(Adafruit_NeoMatrix &matrix) : matrix(matrix) {}
+
+    // copies the gamma correction of Adafruit_NeoMatrix from a matrix of one pixel which is never shown
+    void begin() {
+      // never deleted: the destructor would reset the mode of its pin
+      static Adafruit_NeoMatrix *probe = new Adafruit_NeoMatrix(1, 1, 255, MATRIX_LAYOUT, MATRIX_PIXEL_TYPE);
+      for (int i = 0; i < 64; i++) {
+        if (i < 32) {
+          probe->drawPixel(0, 0, i << 11);
+          gamma5[i] = probe->getPixels()[redOffset];
+        }
+        probe->drawPixel(0, 0, i << 5);
+        gamma6[i] = probe->getPixels()[greenOffset];
+      }
+    }
+
+    void pixel(int16_t x, int16_t y, uint16_t color) {
+      if ((uint16_t)x >= MATRIX_WIDTH || (uint16_t)y >= MATRIX_HEIGHT) {
+        return;
+      }
+      uint8_t rgb[3];
+      expand(color, rgb);
+      write(ledMapTable::map[y * MATRIX_WIDTH + x], rgb);
+    }
+
+    // the set bits of a column (bit y = row y) in the color
+    void column(int16_t x, uint8_t bits, uint16_t color) {
+      if ((uint16_t)x >= MATRIX_WIDTH) {
+        return;
+      }
+      uint8_t rgb[3];
+      expand(color, rgb);
+      for (int y = 0; bits != 0 && y < MATRIX_HEIGHT; y++, bits >>= 1) {
+        if (bits & 1) {
+          write(ledMapTable::map[y * MATRIX_WIDTH + x], rgb);
+        }
+      }
+    }
+
+    void fill(uint16_t color) {
+      uint8_t rgb[3];
+      expand(color, rgb);
+      for (int i = 0; i < MATRIX_WIDTH * MATRIX_HEIGHT; i++) {
+        write(i, rgb);
+      }
+    }
+
+    // RGB565 pixels row by row with the top left corner at x, y
+    void bitmap(int16_t x, int16_t y, const uint16_t *pixels, int16_t width, int16_t height) {
+      for (int16_t row = 0; row < height; row++) {
+        for (int16_t col = 0; col < width; col++) {
+          pixel(x + col, y + row, pixels[row * width + col]);
+        }
+      }
+    }
+
+  private:
+    Adafruit_NeoMatrix &matrix;
+    uint8_t gamma5[32];
+    uint8_t gamma6[64];
+
+    // position of the colors in the pixels of the strip, see Adafruit_NeoPixel
+    static const uint8_t redOffset = (MATRIX_PIXEL_TYPE >> 4) & 3;
+    static const uint8_t greenOffset = (MATRIX_PIXEL_TYPE >> 2) & 3;
+    static const uint8_t blueOffset = MATRIX_PIXEL_TYPE & 3;
+
+    void expand(uint16_t color, uint8_t rgb[3]) {
+      rgb[0] = gamma5[color >> 11];
+      rgb[1] = gamma6[(color >> 5) & 0x3F];
+      rgb[2] = gamma5[color & 0x1F];
+
+      // like Adafruit_NeoPixel::setPixelColor(): 0 = full brightness
+      uint8_t brightness = matrix.getBrightness() + 1;
+      if (brightness != 0) {
+        for (int i = 0; i < 3; i++) {
+          rgb[i] = (rgb[i] * brightness) >> 8;
+        }
+      }
+    }
+
+    void write(uint16_t led, const uint8_t rgb[3]) {
+      uint8_t *p = matrix.getPixels() + led * 3;
+      p[redOffset] = rgb[0];
+      p[greenOffset] = rgb[1];
+      p[blueOffset] = rgb[2];
+    }
+};
+
+LedMap ledMap(matrix);
+
+// draws the image with its top left corner at x, y
+void drawImage(const image &img, int16_t x = 0, int16_t y = 0) {
+  ledMap.bitmap(x, y, img.pixels, img.width, img.height);
+}
@@ -0,0 +1,132 @@
+#include "Arduino.h"
+#include "driver/rmt.h"
+
+/*
+  LED OUTPUT
+
+  The backend which sends a frame to the LEDs. Adafruit_NeoPixel::show() keeps the CPU busy for the whole frame
+  (about 7.7 ms for 256 pixels) with the interrupts disabled, which gets in the way of the Bluetooth stack on core 0.
+
+  RmtOutput encodes the pixels into RMT items up front and lets the RMT peripheral send them: show() returns after
+  about 0.1 ms and the CPU is free while the bits go out. Ws2812Encoder turns every nibble into four items with a
+  lookup table, so encoding a byte is two copies of 16 bytes. NeoPixelOutput is the fallback if the RMT driver can not
+  be installed, NullOutput only counts the frames. All of them send the pixels they are given, not the ones of the
+  matrix, which may already hold the next frame.
+*/
+
+#define LED_OUTPUT_RMT_CHANNEL RMT_CHANNEL_0
+#define LED_OUTPUT_RMT_CLOCK_DIVIDER 2 // 80 MHz / 2: one tick is 25 ns
+
+class LedOutput {
+  public:
+    virtual ~LedOutput() {}
+    virtual bool begin() { return true; }
+    // sends size bytes of pixels in the order of the strip (e.g. GRB), they are copied before show() returns
+    virtual void show(const uint8_t *pixels, size_t size) = 0;
+    // true while a frame is still being sent
+    virtual bool busy() { return false; }
+};
+
+// WS2812 bits as RMT items: high for duration0 ticks, then low for duration1 ticks, the most significant bit first
+class Ws2812Encoder {
+  public:
+    // durations in ticks of the RMT clock, the defaults are the WS2812B timings with 25 ns ticks
+    Ws2812Encoder(uint16_t zeroHigh = 16, uint16_t zeroLow = 34, uint16_t oneHigh = 32, uint16_t oneLow = 18) {
+      uint32_t zero = item(zeroHigh, zeroLow);
+      uint32_t one = item(oneHigh, oneLow);
+      for (int nibble = 0; nibble < 16; nibble++) {
+        for (int bit = 0; bit < 4; bit++) {
+          nibbleItems[nibble][bit] = (nibble & (8 >> bit)) ? one : zero;
+        }
+      }
+    }
+
+    // layout of rmt_item32_t: duration0:15, level0:1, duration1:15, level1:1
+    static uint32_t item(uint16_t high, uint16_t low) {
+      return (uint32_t)high | (1UL << 15) | ((uint32_t)low << 16);
+    }
+
+    // writes 8 items per byte into items and returns the number of items
+    size_t encode(const uint8_t *pixels, size_t size, uint32_t *items) const {
+      for (size_t i = 0; i < size; i++) {
+        memcpy(items, nibbleItems[pixels[i] >> 4], sizeof(nibbleItems[0]));
+        memcpy(items + 4, nibbleItems[pixels[i] & 0x0F], sizeof(nibbleItems[0]));
+        items += 8;
+      }
+      return size * 8;
+    }
+
+  private:
+    uint32_t nibbleItems[16][4];
+};
+
+class RmtOutput : public LedOutput {
+  public:
+    RmtOutput(uint8_t pin, rmt_channel_t channel, size_t maxSize) : pin(pin), channel(channel), maxSize(maxSize) {}
+
+    bool begin() {
+      static_assert(sizeof(rmt_item32_t) == sizeof(uint32_t), "Ws2812Encoder writes rmt_item32_t as uint32_t");
+
+      rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)pin, channel);
+      config.clk_div = LED_OUTPUT_RMT_CLOCK_DIVIDER;
+      config.mem_block_num = 4; // fewer interrupts to refill the memory of the RMT while sending
+      if (rmt_config(&config) != ESP_OK || rmt_driver_install(channel, 0, 0) != ESP_OK) {
+        return false;
+      }
+      items = new uint32_t[maxSize * 8];
+      return true;
+    }
+
+    void show(const uint8_t *pixels, size_t size) {
+      // the driver sends from items: the previous frame has to be out before it is overwritten
+      rmt_wait_tx_done(channel, portMAX_DELAY);
+      size_t count = encoder.encode(pixels, min(size, maxSize), items);
+      rmt_write_items(channel, (const rmt_item32_t *)items, count, false);
+    }
+
+    bool busy() {
+      return rmt_wait_tx_done(channel, 0) != ESP_OK;
+    }
+
+  private:
+    uint8_t pin;
+    rmt_channel_t channel;
+    size_t maxSize; // bytes
+    uint32_t *items = NULL;
+    Ws2812Encoder encoder;
+};
+
+// a strip of Adafruit_NeoPixel of its own which only sends: the pixels are already scaled by the brightness
+class NeoPixelOutput : public LedOutput {
+  public:
+    NeoPixelOutput(uint16_t count, uint8_t pin, neoPixelType type) : strip(count, pin, type) {}
+
+    bool begin() {
+      strip.begin();
+      return true;
+    }
+
+    void show(const uint8_t *pixels, size_t size) {
+      memcpy(strip.getPixels(), pixels, min(size, (size_t)strip.numPixels() * 3));
+      strip.show();
+    }
+
+  private:
+    Adafruit_NeoPixel strip;
+};
+
+// no LEDs: for running the screens without a matrix
+class NullOutput : public LedOutput {
+  public:
+    void show(const uint8_t *pixels, size_t size) {
+      frameCount++;
+    }
+
+    uint32_t frames() { return frameCount; }
+
+  private:
+    uint32_t frameCount = 0;
+};
+
+RmtOutput rmtOutput(PIN, LED_OUTPUT_RMT_CHANNEL, MATRIX_WIDTH * MATRIX_HEIGHT * 3);
+NeoPixelOutput neoPixelOutput(MATRIX_WIDTH * MATRIX_HEIGHT, PIN, MATRIX_PIXEL_TYPE);
@@ -24,7 +24,15 @@
 
 #include "wifi_spots.h"
 #include "images.h"
-#include <EEPROM.h>
+#include "ledmap.h"
+#include "effects.h"
+#include "animation.h"
+#include "settings.h"
+#include "scheduler.h"
+#include "ledoutput.h"
+#include "framebuffer.h"
+#include "textstrip.h"
+#include "screens.h"
 
 #include "music.h"
 
@@ -32,42 +40,19 @@
 TaskHandle_t Core0task; //task to run on core #0
 //TaskHandle_t Core1task; //task to run on core #1 --> replaced by loop()
 
-#define EEPROM_SIZE (byteSizeForMessage + byteSizeForScreen + byteSizeForBrightness + byteSizeForHour + byteSizeForMinute + byteSizeForColors) // define the number of bytes you want to access
-/*
-  byte 1 -> fav color
-  byte 2 -> last screen brightness
-  byte 3..22 -> 20 chars for message
-  byte 23 -> byte for hour
-  byte 24 -> byte for minutes
-*/
-
-void readLastDataFromEEPROM();
+void readLastSettings();
 int firstScan = true; // property similar to PLC because this code is also some sort of a fake RTOS
-void setIntegerToEEPROM(byte byte, int data);
-void setCharToEEPROM(byte byte, char data);
-void setDefaultEEPROM(bool isResetRequired);
-#define HARD_RESET false //DO NOT SET TO TRUE UNLESS YOUR BLUETOOTH CLOCK STOPPED WORKING, THIS CLEARS YOUR SETTINGS AND STOPPS EEPROM FUNCTIONALITY
+void setDefaultSettings(bool isResetRequired);
+#define HARD_RESET false //DO NOT SET TO TRUE UNLESS YOUR BLUETOOTH CLOCK STOPPED WORKING, THIS CLEARS YOUR SETTINGS
 
 // ================== LED MATRIX ================== //
-int favoriteColorNum = 0;
-uint16_t favoriteColor = colors[favoriteColorNum];
-
-int BRIGHTNESS_DAY = 20;
-#define LAST_SCREEN 9
+// the screens and their state are in screens.h
 bool nightModeEnabled = false;
 
-int screenMode = 1; //1 default
-int prevScreen = screenMode;
-bool setupBrightness = false;
-bool setupColor = false;
 bool playMusic = true;
 bool next = false;
 bool prev = false;
 
-#define rainbowTimeout 10 //timeout in ms
-void drawRainbow(int delayBetweenFrames);
-void printText(String text, uint16_t desiredColor);
-
 // ================= BUTTONS AND SCREEN ================ //
 #define CHANGE_MODE 27
 #define PREV_TRACK  32
@@ -87,16 +72,7 @@ unsigned long timeBetweenPlayClick = 0;
 unsigned long timeBetweenNextClick = 0;
 #define buttonTimeout 500 //500 ms
 
-void timeScreen();
-void messageScreen();
-void musicScreen();
-void weatherScreen();
-void loveYouScreen();
-void synthwaveScreen();
-void changeFavoriteColorScreen();
-void brightnessScreen();
-void drawVerticalBar(int x);
-void clearMatrix();
+void presentFrame();
 void connectToMQTT();
 
 // ================== STEREO AUDIO SETUP ================== //
@@ -112,7 +88,6 @@ void Core1loopTask( void * parameter );
 
 
 // ================= DAY AND TIME ====================== //
-String currentTime = " ";
 uint timeTakenAt = 0;
 //unsigned long timeTakenAt = 0;
 uint currentCPUtime = 0;
@@ -121,29 +96,21 @@ const int timeout = 60;
 void connectToWiFi();
 void setCurrentTime(int hour, int minute);
 void setupLocalTime();
+void updateTime();
+void updateMessage();
 
 void setup() {
   Serial.begin(9600);
 
-  //multicore setup
-  xTaskCreatePinnedToCore(
-      Core0loopTask, // Function to implement the task
-      "Core0",       // Name of the task
-      10000,         // Stack size in words
-      NULL,          // Task input parameter
-      0,             // Priority of the task
-      &Core0task,    // Task handle
-      0);            // Core where the task should run
-
   timeBetweenModeClick = millis();
   timeBetweenPrevClick = millis();
   timeBetweenPlayClick = millis();
   timeBetweenNextClick = millis();
 
-  // setup EEPROM
-  EEPROM.begin(EEPROM_SIZE);
-  setDefaultEEPROM(HARD_RESET);
-  readLastDataFromEEPROM();
+  // setup settings
+  settings.begin();
+  setDefaultSettings(HARD_RESET);
+  readLastSettings();
   if (screenMode < 1 || screenMode > LAST_SCREEN) { screenMode = 1; };
   if (BRIGHTNESS_DAY < 10 || BRIGHTNESS_DAY > 100) { BRIGHTNESS_DAY = 50; };
 
@@ -165,7 +132,6 @@ void setup() {
   currentCPUtime = millis()/1000;
   configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
   setCurrentTime(hour, minute); //initial time setup
-  printText(currentTime, favoriteColor);
 
   // mqtt setup
   mqttClient.subscribe(&message);
@@ -173,56 +139,47 @@ void setup() {
   // matrix setup --> do in Core #0
   matrix.begin();
   matrix.setTextWrap(false);
-  matrix.setBrightness(EEPROM.read(2));
-  favoriteColor = colors[EEPROM.read(1)];
+  matrix.setBrightness(BRIGHTNESS_DAY);
+  ledMap.begin();
+  effectRunner.begin();
+  // the RMT sends the frames while the CPU goes on, the NeoPixel library is the fallback
+  LedOutput *output = &rmtOutput;
+  if (!rmtOutput.begin()) {
+    Serial.println("RMT not available, the LEDs are sent by the NeoPixel library");
+    neoPixelOutput.begin();
+    output = &neoPixelOutput;
+  }
+  frameBuffer.begin(*output);
+  favoriteColor = colors[favoriteColorNum];
+
+  //multicore setup: the screens start after the matrix
+  xTaskCreatePinnedToCore(
+      Core0loopTask, // Function to implement the task
+      "Core0",       // Name of the task
+      10000,         // Stack size in words
+      NULL,          // Task input parameter
+      0,             // Priority of the task
+      &Core0task,    // Task handle
+      0);            // Core where the task should run
 }
 
 void Core0loopTask( void * parameter ) {
-  //core 0 task is responsible for the screen and buttons
-  
+  //core 0 task is responsible for the screen, the buttons only change screenMode
+  int currentScreen = 0;
+
+  scheduler.begin(presentFrame);
   while(true) {
-    //Serial.println(screenMode);
     // =========== infinite loop for core #0 =========== //
-    switch (screenMode) {
-      case 1:
-        //time screen
-        timeScreen();
-        break;
-      case 2:
-        // rainbow screen
-        drawRainbow(rainbowTimeout);
-        break;
-      case 3:
-        // message screen
-        messageScreen();
-        break;
-      case 4:
-        // weather screen
-        weatherScreen();
-        break;
-      case 5:
-        // music screen
-        musicScreen();
-        break;
-      case 6:
-        // love you screen
-        loveYouScreen();
-        break;
-      case 7:
-        // synthwave screen
-        synthwaveScreen();
-        break;
-      case 8:
-        // color screen
-        changeFavoriteColorScreen();
-        break;
-      case LAST_SCREEN:
-        // brightness screen
-        brightnessScreen();
-        break;
+    int mode = screenMode;
+    if (mode != currentScreen) {
+      leaveScreen(currentScreen);
+      currentScreen = mode;
+      enterScreen(currentScreen);
+      scheduler.restart(currentScreen);
     }
 
-    delay(1); //needed to allow task watchdog timer to reset
+    // draws one frame, shows it if it has changed and sleeps until the next one, which also resets the task watchdog
+    scheduler.frame(screens[currentScreen]);
     // =========== infinite loop for core #0 =========== //
   }
 }
@@ -236,15 +193,15 @@ void loop() { //COMMUNICATION INTERFACE CONTROL ONLY
     switch (screenMode) {
       case 1:
         //time screen
-        //Serial.println(screenMode);
+        updateTime();
         break;
       case 2:
-        // rainbow screen
+        // rainbow and effects screen
         WiFi.disconnect();
         break;
       case 3:
         // message screen
-        
+        updateMessage();
         break;
       case 4:
         // weather screen
@@ -271,6 +228,9 @@ void loop() { //COMMUNICATION INTERFACE CONTROL ONLY
         break;
     }
 
+    // write changed settings once they are stable
+    settings.loop();
+
     //debug only
     //Serial.println("Screen Mode: " + String(screenMode));
     //Serial.println("Track #: " + String(musicTrackNum));
@@ -281,219 +241,26 @@ void loop() { //COMMUNICATION INTERFACE CONTROL ONLY
 }
 
 ////// SUPPORTING FUNCTIONALITY /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-void setDefaultEEPROM(bool isResetRequired) {
+void setDefaultSettings(bool isResetRequired) {
   if (isResetRequired) {
-    setIntegerToEEPROM(0, 0);
-    setIntegerToEEPROM(1, 50);
-
-    for (int byteNum = 0; byteNum < byteSizeForMessage; byteNum++) {
-      setCharToEEPROM(byteNum + 2, ' ');
-    }
-
-    setIntegerToEEPROM(22, 1);
-    setIntegerToEEPROM(23, 4);
-  }
-}
-
-void readLastDataFromEEPROM() {
-  /*
-    byte 0 -> fav color
-    byte 1 -> last screen brightness
-    byte 2..21 -> 20 chars for message
-    byte 22 -> byte for hour
-    byte 23 -> byte for minutes
-  */
-
-  favoriteColorNum = EEPROM.read(0); // read last favorite color
-  BRIGHTNESS_DAY = EEPROM.read(1);
-
-  // for (int byteNum = 0; byteNum < (unsigned)strlen(messageToClock) && byteNum < byteSizeForMessage; byteNum++) {
-  //   messageToClock[byteNum] = EEPROM.read(byteNum + 2);
-  // }
-
-  hour = EEPROM.read(22);
-  minute = EEPROM.read(23);
-
-  randomGreen = EEPROM.read(24); // to do: rework this
-  randomRed = EEPROM.read(25);
-  randomBlue = EEPROM.read(26);
-
-}
-
-void setIntegerToEEPROM(byte byte, int data) {
-  EEPROM.write(byte, data);
-  EEPROM.commit();
-}
-
-void setCharToEEPROM(byte byte, char data) {
-  EEPROM.write(byte, data);
-  EEPROM.commit();
-}
-
-//screen functions
-void timeScreen() {
-  // time screen
-  currentCPUtime = millis()/1000;
-  if (currentCPUtime - timeTakenAt >= timeout) {
-
-    if (WiFi.status() != WL_CONNECTED) {
-      connectToWiFi();
-    } else if (WiFi.status() == WL_CONNECTED) {
-      setupLocalTime();
-      firstScan = false; // this is where we start caring about the EEPROM to avoid pagefault
-      timeTakenAt = millis()/1000;
-      Serial.println("time taken");
-    }
-
-    printText(currentTime, favoriteColor);
-  } else {
-    WiFi.disconnect();
-    //Serial.println("core 0 task runs on: " + String(xPortGetCoreID()));
-    Serial.println(currentCPUtime - timeTakenAt);
-    //Serial.println(screenMode);
-  }
-}
-
-void messageScreen() {
-  //once connected start manipulation
-  printText(messageToClock, favoriteColor);
-  while (WiFi.status() != WL_CONNECTED && screenMode == 3) {
-    // loop here until you connect to wifi
-    connectToWiFi();
-  }
-
-  connectToMQTT();
-
-  while (screenMode == 3 && mqttClient.connected()) {
-    mqttClient.readSubscription(1000);
-    messageToClock = (char*)message.lastread;
-
-    Serial.println(messageToClock);
-    printText(String(messageToClock), favoriteColor);
-  }
-}
-
-void musicScreen() {
-  printText("music", favoriteColor);
-
-  // aac->begin(in, out);
-
-  // if (aac->isRunning()) {
-  //   aac->loop();
-  // } else {
-  //   aac -> stop();
-  //   Serial.printf("AAC done\n");
-  //   delay(1000);
-  // }
-}
-
-void weatherScreen() {
-  printText("rain", favoriteColor);
-} 
-
-void loveYouScreen() {
-  printText("love", favoriteColor);
-}
-
-void synthwaveScreen() {
-  int pixelNum = 0;
-
-  for (int x = 0; x < 32 && pixelNum < 256; x++) {
-    for (int y = 0; y < 8; y++) {
-      matrix.writePixel(synthwave[pixelNum].x, synthwave[pixelNum].y, matrix.Color(synthwave[pixelNum].green, synthwave[pixelNum].red, synthwave[pixelNum].blue));
-      //delay(100);
-      matrix.show();
-      pixelNum++;
-    }
-  }
-}
-
-void changeFavoriteColorScreen() {
-  bool randomColorSet = false;
-
-  Serial.println("color screen");
-
-  setupColor = false;
-  clearMatrix();
-  while(!setupColor) {
-    if (favoriteColorNum == maxNumOfColors - 1 && !randomColorSet) {
-      randomGreen = random(10, 255); setIntegerToEEPROM(24, randomGreen);
-      randomRed = random(10, 255);   setIntegerToEEPROM(25, randomRed);
-      randomBlue = random(10, 255);  setIntegerToEEPROM(26, randomBlue);
-      randomColorSet = !randomColorSet;
-    } else if (favoriteColorNum != maxNumOfColors - 1) {
-      randomColorSet = false;
-    }
-
-    if (favoriteColorNum < 0) {favoriteColorNum = 0; };
-    if (favoriteColorNum > maxNumOfColors) {favoriteColorNum = maxNumOfColors - 1; };
-
-    favoriteColor = colors[favoriteColorNum];
-
-    Serial.println(favoriteColorNum);
-    
-    for (int i = 0; i < 256; i++) 
-      matrix.setPixelColor(i, favoriteColor);
-
-    matrix.show();
+    settings.reset();
+    settings.commit();
   }
-
-  setIntegerToEEPROM(0, favoriteColorNum);
-
-  screenMode = LAST_SCREEN;
-  clearMatrix();
-  delay(500);
 }
 
-void brightnessScreen() {
-  int brightBar = 0;
-
-  Serial.println("brightness screen");
-
-  setupBrightness = false;
-  while(!setupBrightness) {
-    clearMatrix();
-    brightBar = 3*BRIGHTNESS_DAY/10;
-    drawVerticalBar(brightBar);
-    matrix.setBrightness(BRIGHTNESS_DAY);
-  }
+void readLastSettings() {
+  const settingsLayout &last = settings.get();
 
-  setIntegerToEEPROM(1, BRIGHTNESS_DAY);
+  favoriteColorNum = last.favoriteColorNum; // read last favorite color
+  if (favoriteColorNum >= maxNumOfColors) { favoriteColorNum = 0; };
+  BRIGHTNESS_DAY = last.brightness;
 
-  screenMode = 1;
-  clearMatrix();
-  printText(currentTime, favoriteColor);
-  delay(500);
-}
+  hour = last.hour;
+  minute = last.minute;
 
-// MATRIX LED
-void drawRainbow(int delayBetweenFrames) {
-  for(long firstPixelHue = 0; firstPixelHue < 5*65536 && screenMode == 2; firstPixelHue += 256) {
-    matrix.rainbow(firstPixelHue);
-    matrix.show(); // Update strip with new contents
-    delay(delayBetweenFrames);  // Pause for a moment
-  }
-}
-
-void printText(String text, uint16_t desiredColor) {
-  matrix.setTextColor(desiredColor);
-  matrix.fillScreen(0);
-
-  if (text.length() < 6) {
-    matrix.setCursor(2, 0);
-    matrix.print(text);
-  } else {
-    for (int x = 2; x >= ( (-1)*matrix.width() - 20 ); x-- ) {
-      matrix.fillScreen(0);
-      matrix.setCursor(x, 0);
-      matrix.print(text);
-      matrix.show();
-      delay(100);
-    }
-  }
-  
-  matrix.show();
-  delay(100);
+  randomGreen = last.randomGreen; // to do: rework this
+  randomRed = last.randomRed;
+  randomBlue = last.randomBlue;
 }
 
 // INTERRUPT SERVICE ROUTINES
@@ -508,6 +275,8 @@ void IRAM_ATTR modeISR() {
 
   if (screenMode > LAST_SCREEN)
     screenMode = 1;
+
+  scheduler.wakeFromISR();
 }
 
 void IRAM_ATTR prevISR() {
@@ -525,6 +294,8 @@ void IRAM_ATTR prevISR() {
       if (musicTrackNum <= 0) 
         musicTrackNum = 0;
     }  
+
+    scheduler.wakeFromISR();
   }
 }
 
@@ -547,6 +318,7 @@ void IRAM_ATTR playISR() {
     }  
     
     timeBetweenPlayClick = millis();
+    scheduler.wakeFromISR();
   }
 }
 
@@ -565,6 +337,8 @@ void IRAM_ATTR nextISR() {
       if (musicTrackNum > 10) 
         musicTrackNum = 10;
     }
+
+    scheduler.wakeFromISR();
   }
 }
 
@@ -598,15 +372,9 @@ void connectToWiFi() {
 }
 
 void setCurrentTime(int hour, int minute) {
-  if (hour < 10)
-    currentTime = "0" + String(hour) + ":";
-  else
-    currentTime = String(hour) + ":";
-
-  if (minute < 10)
-    currentTime = currentTime + "0" + String(minute);
-  else
-    currentTime = currentTime + String(minute);
+  char text[sizeof(currentTime)];
+  snprintf(text, sizeof(text), "%02d:%02d", hour, minute);
+  setScreenText(currentTime, sizeof(currentTime), text);
 }
 
 void setupLocalTime(){
@@ -621,25 +389,46 @@ void setupLocalTime(){
 
   setCurrentTime(hour, minute);
 
-  setIntegerToEEPROM(22, hour);
-  setIntegerToEEPROM(23, minute);
+  settings.setTime(hour, minute);
 }
 
-void drawVerticalBar(int x) {
-  for (int currentBar = 0; currentBar <= x; currentBar++) {
-    for (int y = 0; y < 8; y++) {
-      matrix.writePixel(currentBar, y, favoriteColor);
+// refreshes the time once per timeout, runs on core 1
+void updateTime() {
+  currentCPUtime = millis()/1000;
+  if (currentCPUtime - timeTakenAt >= timeout) {
+
+    if (WiFi.status() != WL_CONNECTED) {
+      connectToWiFi();
+    } else if (WiFi.status() == WL_CONNECTED) {
+      setupLocalTime();
+      firstScan = false; // this is where we start caring about the EEPROM to avoid pagefault
+      timeTakenAt = millis()/1000;
+      Serial.println("time taken");
     }
+  } else {
+    WiFi.disconnect();
   }
-  
-  matrix.show();
 }
 
-void clearMatrix() {
-  for(int i = 0; i < 256; i++) {
-    matrix.setPixelColor(i, matrix.Color(0, 0, 0));
+// receives the messages, runs on core 1
+void updateMessage() {
+  if (WiFi.status() != WL_CONNECTED) {
+    connectToWiFi();
+    return;
   }
-  matrix.show();
+
+  connectToMQTT();
+
+  if (mqttClient.connected() && mqttClient.readSubscription(1000)) {
+    // lastread is overwritten by the next readSubscription(): the message screen keeps its own copy
+    setScreenText(currentMessage, sizeof(currentMessage), (const char*)message.lastread);
+    Serial.println((const char*)message.lastread);
+  }
+}
+
+// the only place which sends the pixels to the LEDs, once per frame
+void presentFrame() {
+  frameBuffer.present();
 }
 
 void connectToMQTT() {
@@ -0,0 +1,164 @@
+#include "Arduino.h"
+
+/*
+  FRAME SCHEDULER
+
+  Every screen is a tick function which draws one frame and returns: now is the time in ms since the screen has been
+  entered, so animations and scrolling are based on the time and not on the number of frames. The scheduler calls the
+  tick of the current screen FRAME_RATE times per second, followed by the present function which sends the frame to
+  the LEDs, and sleeps in between. A button press wakes it up, so the next screen is shown within one frame.
+
+  A screen which only changes on a button press, like the settings screens, calls idle() after drawing: the scheduler
+  then sleeps until a button wakes it up instead of drawing the same frame FRAME_RATE times per second.
+
+  When a screen is left, the scheduler reports how many frames it has drawn and how long its tick took on average,
+  which is the cost of the screen without the time to send the frames.
+*/
+
+#define FRAME_RATE 30 // frames per second
+#define FRAME_REPORT_INTERVAL 10000 // ms between the statistics on the serial port, 0 = no statistics
+#define FRAME_IDLE_TIMEOUT 1000 // ms: an idle screen is drawn at least this often, in case a wake up is missed
+
+typedef void (*screenTick)(unsigned long now);
+typedef void (*framePresent)();
+
+class FrameScheduler {
+  public:
+    FrameScheduler(uint16_t fps) {
+      framePeriod = 1000000 / fps;
+    }
+
+    // call it from the task which runs the frames
+    void begin(framePresent present = NULL) {
+      presentFrame = present;
+      task = xTaskGetCurrentTaskHandle();
+      nextFrame = micros();
+      reportStart = millis();
+      restart(0);
+    }
+
+    // the time of the screen starts again at 0
+    void restart(int screen) {
+      reportScreen();
+      currentScreen = screen;
+      screenStart = millis();
+      screenFrames = 0;
+      screenTickTime = 0;
+      maxTickTime = 0;
+    }
+
+    // draws one frame of the screen and waits for the next one
+    void frame(screenTick tick) {
+      unsigned long start = micros();
+      tick(millis() - screenStart);
+      unsigned long tickTime = micros() - start;
+      screenFrames++;
+      screenTickTime += tickTime;
+      if (tickTime > maxTickTime) { maxTickTime = tickTime; };
+      if (presentFrame != NULL) {
+        presentFrame();
+      }
+      lastFrameTime = micros() - start;
+
+      frameCount++;
+      intervalFrames++;
+      intervalFrameTime += lastFrameTime;
+      if (lastFrameTime > maxFrameTime) { maxFrameTime = lastFrameTime; };
+
+      if (isIdle) {
+        // nothing to draw until a button is pressed
+        isIdle = false;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FRAME_IDLE_TIMEOUT));
+        nextFrame = micros();
+        report();
+        return;
+      }
+
+      nextFrame += framePeriod;
+      long wait = (long)(nextFrame - micros());
+      if (wait <= 0) {
+        // too late: we continue from now instead of rushing to catch up
+        missedCount++;
+        nextFrame = micros();
+        wait = 0;
+      }
+
+      // we always block for at least one tick to let the watchdog of the idle task run
+      TickType_t ticks = pdMS_TO_TICKS(wait / 1000);
+      if (ulTaskNotifyTake(pdTRUE, ticks > 0 ? ticks : 1) > 0) {
+        // woken up by a button: the next frame starts now
+        nextFrame = micros();
+      }
+
+      report();
+    }
+
+    // the current screen does not change until the next wake up: call it from the tick
+    void idle() {
+      isIdle = true;
+    }
+
+    // wakes up the scheduler, e.g. after a button press
+    void IRAM_ATTR wakeFromISR() {
+      if (task == NULL) {
+        return;
+      }
+      BaseType_t higherPriorityTaskWoken = pdFALSE;
+      vTaskNotifyGiveFromISR(task, &higherPriorityTaskWoken);
+      if (higherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+      }
+    }
+
+    uint32_t frames() { return frameCount; }
+    uint32_t missedDeadlines() { return missedCount; }
+    unsigned long frameTime() { return lastFrameTime; } // us
+
+  private:
+    TaskHandle_t task = NULL;
+    framePresent presentFrame = NULL;
+    unsigned long framePeriod; // us
+    unsigned long nextFrame = 0;
+    unsigned long screenStart = 0;
+    unsigned long lastFrameTime = 0;
+    uint32_t frameCount = 0;
+    uint32_t missedCount = 0;
+    bool isIdle = false;
+
+    unsigned long reportStart = 0;
+    uint32_t intervalFrames = 0;
+    uint64_t intervalFrameTime = 0;
+    unsigned long maxFrameTime = 0;
+
+    int currentScreen = 0;
+    uint32_t screenFrames = 0;
+    uint64_t screenTickTime = 0;
+    unsigned long maxTickTime = 0;
+
+    void report() {
+      if (FRAME_REPORT_INTERVAL == 0 || millis() - reportStart < FRAME_REPORT_INTERVAL) {
+        return;
+      }
+      unsigned long interval = millis() - reportStart;
+      // load: share of the time which core 0 spends drawing and presenting frames
+      Serial.printf("fps: %.1f frame time: avg %lu us max %lu us load: %.1f%% missed deadlines: %u\n",
+        intervalFrames * 1000.0 / interval, (unsigned long)(intervalFrameTime / intervalFrames), maxFrameTime,
+        intervalFrameTime / (interval * 10.0), missedCount);
+
+      reportStart = millis();
+      intervalFrames = 0;
+      intervalFrameTime = 0;
+      maxFrameTime = 0;
+    }
+
+    void reportScreen() {
+      unsigned long duration = millis() - screenStart;
+      if (FRAME_REPORT_INTERVAL == 0 || screenFrames == 0 || duration == 0) {
+        return;
+      }
+      Serial.printf("screen %d: %u frames in %lu ms (%.1f fps) tick: avg %lu us max %lu us\n", currentScreen,
+        screenFrames, duration, screenFrames * 1000.0 / duration, (unsigned long)(screenTickTime / screenFrames), maxTickTime);
+    }
+};
+
+FrameScheduler scheduler(FRAME_RATE);
@@ -0,0 +1,218 @@
+#include "Arduino.h"
+
+/*
+  SCREENS
+
+  One frame of every screen: the scheduler on core 0 calls screens[screenMode] with the time in ms since the screen
+  has been entered, enterScreen() and leaveScreen() when it switches to another screen. The buttons and loop() in
+  main.cpp only change the state below. The screens draw into the pixels of the matrix and never send them, so they
+  also run on the host, see test/test_screens.
+*/
+
+int favoriteColorNum = 0;
+uint16_t favoriteColor = colors[favoriteColorNum];
+
+int BRIGHTNESS_DAY = 20;
+#define LAST_SCREEN 9
+
+int screenMode = 1; //1 default
+int prevScreen = screenMode;
+bool setupBrightness = false;
+bool setupColor = false;
+int shownColorNum = -1; // the settings screens draw again when the value differs from the shown one
+int shownBrightness = -1;
+
+// the texts which loop() on core 1 receives: the screens own the buffers and draw a copy which is taken under
+// screenTextMux, so a text never changes while core 0 measures and scrolls it
+portMUX_TYPE screenTextMux = portMUX_INITIALIZER_UNLOCKED;
+char currentTime[6] = " ";
+char currentMessage[SUBSCRIPTIONDATALEN + 1] = "msg";
+
+// core 1: replaces one of the texts above
+void setScreenText(char *text, size_t size, const char *value) {
+  portENTER_CRITICAL(&screenTextMux);
+  strncpy(text, value, size - 1);
+  text[size - 1] = '\0';
+  portEXIT_CRITICAL(&screenTextMux);
+}
+
+// core 0: the copy which is drawn
+void copyScreenText(char *copy, const char *text, size_t size) {
+  portENTER_CRITICAL(&screenTextMux);
+  memcpy(copy, text, size);
+  portEXIT_CRITICAL(&screenTextMux);
+}
+
+AnimationPlayer heartPlayer(heart); // love you screen
+
+#define scrollTimeout 100 //ms per column of scrolling text
+void printText(const char *text, uint16_t desiredColor, unsigned long now);
+void drawVerticalBar(int x);
+void clearMatrix();
+
+// screen functions: one frame each, now = ms since the screen has been entered
+void timeScreen(unsigned long now) {
+  // the time is updated by loop() on core 1
+  char text[sizeof(currentTime)];
+  copyScreenText(text, currentTime, sizeof(text));
+  printText(text, favoriteColor, now);
+}
+
+void messageScreen(unsigned long now) {
+  // the message is received by loop() on core 1
+  char text[sizeof(currentMessage)];
+  copyScreenText(text, currentMessage, sizeof(text));
+  printText(text, favoriteColor, now);
+}
+
+void musicScreen(unsigned long now) {
+  printText("music", favoriteColor, now);
+
+  // aac->begin(in, out);
+
+  // if (aac->isRunning()) {
+  //   aac->loop();
+  // } else {
+  //   aac -> stop();
+  //   Serial.printf("AAC done\n");
+  //   delay(1000);
+  // }
+}
+
+void weatherScreen(unsigned long now) {
+  printText("rain", favoriteColor, now);
+}
+
+void loveYouScreen(unsigned long now) {
+  // no fillScreen() here: the heart only draws the pixels which change
+  heartPlayer.draw(now);
+
+  matrix.setTextColor(favoriteColor);
+  matrix.setCursor(9, 0);
+  matrix.print("love");
+}
+
+void synthwaveScreen(unsigned long now) {
+  drawImage(synthwave);
+}
+
+bool randomColorSet = false;
+
+// the settings screens only draw when the buttons have changed their value and sleep in between
+void changeFavoriteColorScreen(unsigned long now) {
+  if (setupColor) {
+    // color confirmed, the color is saved when we leave the screen
+    screenMode = LAST_SCREEN;
+    return;
+  }
+
+  if (favoriteColorNum < 0) {favoriteColorNum = 0; };
+  if (favoriteColorNum >= maxNumOfColors) {favoriteColorNum = maxNumOfColors - 1; };
+
+  if (favoriteColorNum != shownColorNum) {
+    shownColorNum = favoriteColorNum;
+
+    if (favoriteColorNum == maxNumOfColors - 1 && !randomColorSet) {
+      randomGreen = random(10, 255);
+      randomRed = random(10, 255);
+      randomBlue = random(10, 255);
+      settings.setRandomColor(randomGreen, randomRed, randomBlue);
+      randomColorSet = !randomColorSet;
+    } else if (favoriteColorNum != maxNumOfColors - 1) {
+      randomColorSet = false;
+    }
+
+    favoriteColor = colors[favoriteColorNum];
+
+    Serial.println(favoriteColorNum);
+
+    ledMap.fill(favoriteColor);
+  }
+
+  scheduler.idle();
+}
+
+void brightnessScreen(unsigned long now) {
+  // the play button confirms the brightness and switches to the time screen, see playISR()
+  if (BRIGHTNESS_DAY != shownBrightness) {
+    shownBrightness = BRIGHTNESS_DAY;
+
+    // the brightness first: ledMap applies it while drawing
+    matrix.setBrightness(BRIGHTNESS_DAY);
+    clearMatrix();
+    drawVerticalBar(3*BRIGHTNESS_DAY/10);
+  }
+
+  scheduler.idle();
+}
+
+void effectsScreen(unsigned long now) {
+  // the rainbow first, then every EFFECT_DURATION ms the next effect
+  int number = (now / EFFECT_DURATION) % numberOfEffects;
+  if (&effectRunner.getEffect() != &effects[number]) {
+    effectRunner.setEffect(number);
+  }
+  effectRunner.draw(now);
+}
+
+// one frame of each screen, index = screenMode
+const screenTick screens[LAST_SCREEN + 1] = {
+  NULL,
+  timeScreen,
+  effectsScreen,
+  messageScreen,
+  weatherScreen,
+  musicScreen,
+  loveYouScreen,
+  synthwaveScreen,
+  changeFavoriteColorScreen,
+  brightnessScreen
+};
+
+void enterScreen(int mode) {
+  matrix.fillScreen(0);
+
+  if (mode == 6) {
+    heartPlayer.invalidate();
+  } else if (mode == 8) {
+    Serial.println("color screen");
+    setupColor = false;
+    shownColorNum = -1;
+  } else if (mode == LAST_SCREEN) {
+    Serial.println("brightness screen");
+    setupBrightness = false;
+    shownBrightness = -1;
+  }
+}
+
+void leaveScreen(int mode) {
+  // the settings store only writes values which have changed
+  if (mode == 8) {
+    settings.setFavoriteColor(favoriteColorNum);
+  } else if (mode == LAST_SCREEN) {
+    settings.setBrightness(BRIGHTNESS_DAY);
+  }
+}
+
+void printText(const char *text, uint16_t desiredColor, unsigned long now) {
+  // the text is only rendered when it changes, every frame copies a window of it
+  textStrip.setText(text);
+
+  if (strlen(text) < 6) {
+    textStrip.draw(2, desiredColor);
+  } else {
+    // scrolls one column every scrollTimeout ms until the text has left the matrix, then starts again
+    int scrollLength = 2 + textStrip.width();
+    textStrip.draw(2 - (int)((now / scrollTimeout) % (scrollLength + 1)), desiredColor);
+  }
+}
+
+void drawVerticalBar(int x) {
+  for (int currentBar = 0; currentBar <= x; currentBar++) {
+    ledMap.column(currentBar, 0xFF, favoriteColor);
+  }
+}
+
+void clearMatrix() {
+  ledMap.fill(0);
+}
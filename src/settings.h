@@ -0,0 +1,256 @@
+#include "Arduino.h"
+#include <EEPROM.h>
+#include "settings_journal.h"
+
+/*
+  SETTINGS STORE
+
+  All settings live in a RAM copy. The setters only mark it as dirty and the copy is written to the flash
+  when nothing has changed for SETTINGS_COMMIT_DELAY ms, so several changes in a row result in a single commit.
+
+  The settings are kept in the wear leveled journal on the SETTINGS_PARTITION of partitions.csv. Without that
+  partition we fall back to the EEPROM, where the layout is versioned and protected by a CRC: increase SETTINGS_VERSION
+  whenever settingsLayout changes.
+*/
+
+#define SETTINGS_VERSION 1
+#define SETTINGS_COMMIT_DELAY 5000 // ms without changes before we write to the flash
+#define SETTINGS_PARTITION "settings"
+
+// keys of the settings in the journal: never reuse a key for something else
+enum settingsKey {
+  KEY_FAVORITE_COLOR = 1,
+  KEY_BRIGHTNESS = 2,
+  KEY_TIME = 3,
+  KEY_RANDOM_COLOR = 4,
+  KEY_MESSAGE = 5
+};
+
+struct __attribute__((packed)) settingsLayout {
+  uint8_t version;
+  uint8_t favoriteColorNum;
+  uint8_t brightness;
+  char message[byteSizeForMessage];
+  uint8_t hour;
+  uint8_t minute;
+  uint8_t randomGreen;
+  uint8_t randomRed;
+  uint8_t randomBlue;
+  uint16_t crc; // always the last field
+};
+
+class SettingsStore {
+  public:
+    // loads the settings: returns false if the defaults had to be used
+    bool begin() {
+      PartitionFlashBackend *partition = new PartitionFlashBackend(SETTINGS_PARTITION);
+      if (partition->isAvailable() && journal.begin(partition)) {
+        useJournal = true;
+        if (loadJournal()) {
+          return true;
+        }
+        // first start with the journal: we take over the settings from the EEPROM
+        loadEEPROM();
+        commit();
+        return false;
+      }
+
+      delete partition;
+      Serial.println("no settings partition: using the EEPROM");
+      if (loadEEPROM()) {
+        return true;
+      }
+      commit();
+      return false;
+    }
+
+    const settingsLayout &get() {
+      return current;
+    }
+
+    void setFavoriteColor(uint8_t colorNum) { update(&current.favoriteColorNum, &colorNum, 1); }
+    void setBrightness(uint8_t brightness) { update(&current.brightness, &brightness, 1); }
+
+    void setTime(uint8_t hour, uint8_t minute) {
+      uint8_t time[2] = { hour, minute };
+      update(&current.hour, time, 2);
+    }
+
+    void setRandomColor(uint8_t green, uint8_t red, uint8_t blue) {
+      uint8_t color[3] = { green, red, blue };
+      update(&current.randomGreen, color, 3);
+    }
+
+    void setMessage(const char *message) {
+      char text[byteSizeForMessage] = { 0 };
+      strncpy(text, message, byteSizeForMessage);
+      update(current.message, text, byteSizeForMessage);
+    }
+
+    void reset() {
+      portENTER_CRITICAL(&mux);
+      setDefaults();
+      markDirty();
+      portEXIT_CRITICAL(&mux);
+    }
+
+    // writes the settings when they have been stable for SETTINGS_COMMIT_DELAY ms, call it regularly
+    void loop() {
+      if (dirty && millis() - lastChange >= SETTINGS_COMMIT_DELAY) {
+        commit();
+      }
+    }
+
+    // writes pending changes immediately
+    void commit() {
+      settingsLayout snapshot;
+      uint32_t snapshotGeneration;
+
+      portENTER_CRITICAL(&mux);
+      snapshot = current;
+      snapshotGeneration = generation;
+      portEXIT_CRITICAL(&mux);
+
+      if (!(useJournal ? writeJournal(snapshot) : writeEEPROM(snapshot))) {
+        // loop() tries again after SETTINGS_COMMIT_DELAY ms, not on every pass with a compaction each time
+        portENTER_CRITICAL(&mux);
+        lastChange = millis();
+        portEXIT_CRITICAL(&mux);
+        Serial.println("settings commit failed");
+        return;
+      }
+      commitCount++;
+
+      // the settings might have been changed in the meantime by the other core
+      portENTER_CRITICAL(&mux);
+      if (generation == snapshotGeneration) {
+        dirty = false;
+      }
+      portEXIT_CRITICAL(&mux);
+    }
+
+    bool isDirty() { return dirty; }
+    uint32_t commits() { return commitCount; }
+    uint32_t compactions() { return journal.compactions(); }
+
+  private:
+    settingsLayout current;
+    SettingsJournal journal;
+    bool useJournal = false;
+    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+    volatile bool dirty = false;
+    volatile uint32_t generation = 0;
+    volatile unsigned long lastChange = 0;
+    uint32_t commitCount = 0;
+
+    // only values which are different make the settings dirty
+    void update(void *field, const void *value, size_t len) {
+      portENTER_CRITICAL(&mux);
+      if (memcmp(field, value, len) != 0) {
+        memcpy(field, value, len);
+        markDirty();
+      }
+      portEXIT_CRITICAL(&mux);
+    }
+
+    void markDirty() {
+      dirty = true;
+      generation++;
+      lastChange = millis();
+    }
+
+    bool loadEEPROM() {
+      EEPROM.begin(sizeof(settingsLayout));
+      EEPROM.get(0, current);
+
+      if (current.version == SETTINGS_VERSION && current.crc == crc(current)) {
+        return true;
+      }
+
+      if (!loadLegacy()) {
+        setDefaults();
+      }
+      return false;
+    }
+
+    bool writeEEPROM(settingsLayout &snapshot) {
+      snapshot.version = SETTINGS_VERSION;
+      snapshot.crc = crc(snapshot);
+      EEPROM.put(0, snapshot);
+      return EEPROM.commit();
+    }
+
+    // keys which have never been written keep their default
+    bool loadJournal() {
+      setDefaults();
+      if (journal.isEmpty()) {
+        return false;
+      }
+      journal.read(KEY_FAVORITE_COLOR, &current.favoriteColorNum, 1);
+      journal.read(KEY_BRIGHTNESS, &current.brightness, 1);
+      journal.read(KEY_TIME, &current.hour, 2);
+      journal.read(KEY_RANDOM_COLOR, &current.randomGreen, 3);
+      journal.read(KEY_MESSAGE, current.message, byteSizeForMessage);
+      return true;
+    }
+
+    // the journal only appends the values which have changed
+    bool writeJournal(const settingsLayout &snapshot) {
+      return journal.write(KEY_FAVORITE_COLOR, &snapshot.favoriteColorNum, 1)
+        && journal.write(KEY_BRIGHTNESS, &snapshot.brightness, 1)
+        && journal.write(KEY_TIME, &snapshot.hour, 2)
+        && journal.write(KEY_RANDOM_COLOR, &snapshot.randomGreen, 3)
+        && journal.write(KEY_MESSAGE, snapshot.message, byteSizeForMessage);
+    }
+
+    void setDefaults() {
+      memset(&current, 0, sizeof(current));
+      current.version = SETTINGS_VERSION;
+      current.favoriteColorNum = 0;
+      current.brightness = 50;
+      memset(current.message, ' ', byteSizeForMessage);
+      current.hour = 1;
+      current.minute = 4;
+    }
+
+    // settings which have been written before the settings store: byte 0 -> fav color, byte 1 -> brightness,
+    // byte 2..21 -> message, byte 22 -> hour, byte 23 -> minute, byte 24..26 -> random color
+    bool loadLegacy() {
+      uint8_t legacy[27];
+      for (int i = 0; i < (int)sizeof(legacy); i++) {
+        legacy[i] = EEPROM.read(i);
+      }
+
+      if (legacy[0] >= maxNumOfColors || legacy[1] < 10 || legacy[1] > 100 || legacy[22] > 23 || legacy[23] > 59) {
+        return false;
+      }
+
+      memset(&current, 0, sizeof(current));
+      current.version = SETTINGS_VERSION;
+      current.favoriteColorNum = legacy[0];
+      current.brightness = legacy[1];
+      memcpy(current.message, legacy + 2, byteSizeForMessage);
+      current.hour = legacy[22];
+      current.minute = legacy[23];
+      current.randomGreen = legacy[24];
+      current.randomRed = legacy[25];
+      current.randomBlue = legacy[26];
+      Serial.println("settings migrated");
+      return true;
+    }
+
+    // CRC-16/CCITT over everything but the crc itself
+    static uint16_t crc(const settingsLayout &layout) {
+      const uint8_t *data = (const uint8_t *)&layout;
+      uint16_t result = 0xFFFF;
+      for (size_t i = 0; i < offsetof(settingsLayout, crc); i++) {
+        result ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+          result = (result & 0x8000) ? (result << 1) ^ 0x1021 : (result << 1);
+        }
+      }
+      return result;
+    }
+};
+
+SettingsStore settings;
@@ -0,0 +1,256 @@
+#include "Arduino.h"
+#include "esp_partition.h"
+
+/*
+  SETTINGS JOURNAL
+
+  Append-only key/value log for the settings. Changed values are appended as records to the active flash sector.
+  When the sector is full, the latest value of every key is copied into the next sector and the log continues there,
+  so the erases rotate across all sectors.
+
+  sector: header (magic, sequence) + records
+  record: key, length, crc16, data (padded to 4 bytes)
+
+  The header of a sector is written after its records have been copied, so a power loss during the copy leaves the
+  previous sector active. A torn record fails its CRC and the journal is compacted at the next start.
+*/
+
+#define SETTINGS_JOURNAL_MAGIC 0x4E52534A // "JSRN"
+#define SETTINGS_JOURNAL_KEYS 8
+#define SETTINGS_JOURNAL_MAX_VALUE 24
+#define SETTINGS_JOURNAL_HEADER 8
+
+// flash which is used by the journal: erased bytes are 0xFF and writes can only clear bits
+class FlashBackend {
+  public:
+    virtual ~FlashBackend() {}
+    virtual uint32_t sectorSize() = 0;
+    virtual uint32_t sectorCount() = 0;
+    virtual bool read(uint32_t address, void *data, uint32_t len) = 0;
+    virtual bool write(uint32_t address, const void *data, uint32_t len) = 0;
+    virtual bool erase(uint32_t sector) = 0;
+};
+
+// data partition of partitions.csv
+class PartitionFlashBackend : public FlashBackend {
+  public:
+    PartitionFlashBackend(const char *label) {
+      partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    }
+
+    bool isAvailable() { return partition != NULL; }
+    uint32_t sectorSize() { return SPI_FLASH_SEC_SIZE; }
+    uint32_t sectorCount() { return partition == NULL ? 0 : partition->size / SPI_FLASH_SEC_SIZE; }
+
+    bool read(uint32_t address, void *data, uint32_t len) {
+      return esp_partition_read(partition, address, data, len) == ESP_OK;
+    }
+
+    bool write(uint32_t address, const void *data, uint32_t len) {
+      return esp_partition_write(partition, address, data, len) == ESP_OK;
+    }
+
+    bool erase(uint32_t sector) {
+      return esp_partition_erase_range(partition, sector * SPI_FLASH_SEC_SIZE, SPI_FLASH_SEC_SIZE) == ESP_OK;
+    }
+
+  private:
+    const esp_partition_t *partition;
+};
+
+class SettingsJournal {
+  public:
+    // mounts the journal: returns false if the flash is not usable
+    bool begin(FlashBackend *backend) {
+      flash = backend;
+      if (flash == NULL || flash->sectorCount() < 2) {
+        return false;
+      }
+      memset(lengths, 0, sizeof(lengths));
+
+      // the valid sector with the highest sequence is the active one
+      bool found = false;
+      for (uint32_t sector = 0; sector < flash->sectorCount(); sector++) {
+        uint32_t header[2];
+        if (flash->read(sector * flash->sectorSize(), header, sizeof(header)) && header[0] == SETTINGS_JOURNAL_MAGIC
+            && (!found || header[1] > sequence)) {
+          found = true;
+          activeSector = sector;
+          sequence = header[1];
+        }
+      }
+
+      if (!found) {
+        // empty flash: we start with an empty log in the first sector
+        uint32_t header[2] = { SETTINGS_JOURNAL_MAGIC, 1 };
+        activeSector = 0;
+        sequence = 1;
+        writePos = SETTINGS_JOURNAL_HEADER;
+        return flash->erase(0) && flash->write(0, header, sizeof(header));
+      }
+
+      if (!replay()) {
+        Serial.println("settings journal: damaged record, compacting");
+        return compact();
+      }
+      return true;
+    }
+
+    // latest value of the key: returns false if it has never been written
+    bool read(uint8_t key, void *data, uint8_t len) {
+      if (key >= SETTINGS_JOURNAL_KEYS || lengths[key] != len) {
+        return false;
+      }
+      memcpy(data, values[key], len);
+      return true;
+    }
+
+    // appends the value if it is different from the last one
+    bool write(uint8_t key, const void *data, uint8_t len) {
+      if (key == 0 || key >= SETTINGS_JOURNAL_KEYS || len > SETTINGS_JOURNAL_MAX_VALUE) {
+        return false;
+      }
+      if (lengths[key] == len && memcmp(values[key], data, len) == 0) {
+        return true;
+      }
+      // the records are written from the cache: if that fails the old value goes back, so a retry writes again
+      uint8_t previous[SETTINGS_JOURNAL_MAX_VALUE];
+      uint8_t previousLen = lengths[key];
+      memcpy(previous, values[key], previousLen);
+      memcpy(values[key], data, len);
+      lengths[key] = len;
+
+      bool written;
+      if (writePos + recordSize(len) > flash->sectorSize()) {
+        // the compaction writes the new value as well
+        written = compact();
+      } else {
+        written = writeRecord(activeSector, writePos, key);
+        if (!written) {
+          // the record may be partly written: the next write starts a new sector
+          writePos = flash->sectorSize();
+        }
+      }
+      if (!written) {
+        memcpy(values[key], previous, previousLen);
+        lengths[key] = previousLen;
+      }
+      return written;
+    }
+
+    bool isEmpty() {
+      for (int key = 0; key < SETTINGS_JOURNAL_KEYS; key++) {
+        if (lengths[key] > 0) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    uint32_t compactions() { return compactionCount; }
+
+  private:
+    FlashBackend *flash = NULL;
+    uint32_t activeSector = 0;
+    uint32_t sequence = 0;
+    uint32_t writePos = SETTINGS_JOURNAL_HEADER;
+    uint32_t compactionCount = 0;
+    uint8_t values[SETTINGS_JOURNAL_KEYS][SETTINGS_JOURNAL_MAX_VALUE];
+    uint8_t lengths[SETTINGS_JOURNAL_KEYS];
+
+    static uint32_t recordSize(uint8_t len) {
+      return (4 + len + 3) & ~3;
+    }
+
+    // reads all records of the active sector: returns false if a record is damaged
+    bool replay() {
+      uint32_t base = activeSector * flash->sectorSize();
+      writePos = SETTINGS_JOURNAL_HEADER;
+
+      while (writePos + 4 <= flash->sectorSize()) {
+        uint8_t record[4 + SETTINGS_JOURNAL_MAX_VALUE];
+        flash->read(base + writePos, record, 4);
+        uint8_t key = record[0];
+        uint8_t len = record[1];
+        if (key == 0xFF) {
+          return true; // end of the log
+        }
+        if (key == 0 || key >= SETTINGS_JOURNAL_KEYS || len > SETTINGS_JOURNAL_MAX_VALUE || writePos + recordSize(len) > flash->sectorSize()) {
+          return false;
+        }
+        flash->read(base + writePos + 4, record + 4, len);
+        if (crc(record, len) != (uint16_t)(record[2] | (record[3] << 8))) {
+          return false;
+        }
+        memcpy(values[key], record + 4, len);
+        lengths[key] = len;
+        writePos += recordSize(len);
+      }
+      return true;
+    }
+
+    bool writeRecord(uint32_t sector, uint32_t pos, uint8_t key) {
+      uint8_t record[4 + SETTINGS_JOURNAL_MAX_VALUE + 3];
+      uint8_t len = lengths[key];
+      uint32_t size = recordSize(len);
+      memset(record, 0xFF, sizeof(record));
+      record[0] = key;
+      record[1] = len;
+      memcpy(record + 4, values[key], len);
+      uint16_t check = crc(record, len);
+      record[2] = check & 0xFF;
+      record[3] = check >> 8;
+
+      if (!flash->write(sector * flash->sectorSize() + pos, record, size)) {
+        return false;
+      }
+      if (sector == activeSector) {
+        writePos = pos + size;
+      }
+      return true;
+    }
+
+    // copies the latest values into the next sector which then becomes the active one
+    bool compact() {
+      uint32_t next = (activeSector + 1) % flash->sectorCount();
+      if (!flash->erase(next)) {
+        return false;
+      }
+
+      uint32_t pos = SETTINGS_JOURNAL_HEADER;
+      for (uint8_t key = 1; key < SETTINGS_JOURNAL_KEYS; key++) {
+        if (lengths[key] > 0) {
+          if (!writeRecord(next, pos, key)) {
+            return false;
+          }
+          pos += recordSize(lengths[key]);
+        }
+      }
+
+      // the header makes the copy valid
+      uint32_t header[2] = { SETTINGS_JOURNAL_MAGIC, sequence + 1 };
+      if (!flash->write(next * flash->sectorSize(), header, sizeof(header))) {
+        return false;
+      }
+      activeSector = next;
+      sequence++;
+      writePos = pos;
+      compactionCount++;
+      return true;
+    }
+
+    // CRC-16/CCITT over key, length and data
+    static uint16_t crc(const uint8_t *record, uint8_t len) {
+      uint16_t result = 0xFFFF;
+      for (int i = 0; i < 4 + len; i++) {
+        if (i == 2 || i == 3) {
+          continue; // the crc itself
+        }
+        result ^= (uint16_t)record[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+          result = (result & 0x8000) ? (result << 1) ^ 0x1021 : (result << 1);
+        }
+      }
+      return result;
+    }
+};
@@ -0,0 +1,63 @@
+#include "Arduino.h"
+
+/*
+  TEXT STRIP
+
+  The text is rendered once with the font of Adafruit_GFX into a strip of columns, one byte per column (bit y = row y).
+  Scrolling then only copies a window of the strip into the matrix instead of printing the whole text for every
+  column of movement. The strip is rendered again when the text changes, the color is applied while copying.
+*/
+
+class TextStrip {
+  public:
+    // renders the text if it is different from the last one
+    void setText(const char *text) {
+      if (columns != NULL && shownText == text) {
+        return;
+      }
+      shownText = text;
+
+      int length = strlen(text);
+      stripWidth = 6 * length; // 5 pixels per character + 1 space
+      delete[] columns;
+      columns = new uint8_t[max(stripWidth, 1)];
+      memset(columns, 0, max(stripWidth, 1));
+      if (stripWidth == 0) {
+        return;
+      }
+
+      GFXcanvas1 canvas(stripWidth, 8);
+      canvas.setTextWrap(false);
+      canvas.setTextColor(1);
+      canvas.setCursor(0, 0);
+      canvas.print(text);
+      for (int x = 0; x < stripWidth; x++) {
+        for (int y = 0; y < 8; y++) {
+          if (canvas.getPixel(x, y)) {
+            columns[x] |= 1 << y;
+          }
+        }
+      }
+    }
+
+    // width of the text in pixels
+    int width() { return stripWidth; }
+
+    // draws the strip with its first column at x, the rest of the matrix is cleared
+    void draw(int x, uint16_t color) {
+      ledMap.fill(0);
+
+      int first = max(0, -x);
+      int last = min(stripWidth, MATRIX_WIDTH - x);
+      for (int stripColumn = first; stripColumn < last; stripColumn++) {
+        ledMap.column(x + stripColumn, columns[stripColumn], color);
+      }
+    }
+
+  private:
+    String shownText;
+    uint8_t *columns = NULL;
+    int stripWidth = 0;
+};
+
+TextStrip textStrip;
@@ -30,8 +30,6 @@ const int byteSizeForHour = 1;
 const int byteSizeForMinute = 1;
 const int byteSizeForColors = 3;
 
-char *messageToClock = "msg";
-
 const int numberOfHotspots = 3;
 
 const char *ssid[numberOfHotspots] = { "TELUS0903", 
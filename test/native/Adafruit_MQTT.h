@@ -0,0 +1,26 @@
+// Host stand-in of the Adafruit MQTT Library for pio test -e native: there is never a connection
+#pragma once
+
+#include "Arduino.h"
+
+#define SUBSCRIPTIONDATALEN 20
+
+class Adafruit_MQTT_Subscribe;
+
+class Adafruit_MQTT {
+  public:
+    bool connected() { return false; }
+    int8_t connect() { return -1; }
+    bool disconnect() { return true; }
+    bool subscribe(Adafruit_MQTT_Subscribe *sub) { return true; }
+    Adafruit_MQTT_Subscribe *readSubscription(int16_t timeout = 0) { return NULL; }
+    const char *connectErrorString(int8_t code) { return "no network on the host"; }
+};
+
+class Adafruit_MQTT_Subscribe {
+  public:
+    Adafruit_MQTT_Subscribe(Adafruit_MQTT *mqttserver, const char *feedname, uint8_t q = 0) : topic(feedname) {}
+
+    const char *topic;
+    uint8_t lastread[SUBSCRIPTIONDATALEN] = { 0 };
+};
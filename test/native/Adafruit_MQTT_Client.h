@@ -0,0 +1,10 @@
+// Host stand-in of the Adafruit MQTT Library for pio test -e native, see Adafruit_MQTT.h
+#pragma once
+
+#include "Adafruit_MQTT.h"
+#include "WiFi.h"
+
+class Adafruit_MQTT_Client : public Adafruit_MQTT {
+  public:
+    Adafruit_MQTT_Client(Client *client, const char *server, uint16_t port, const char *user, const char *pass) {}
+};
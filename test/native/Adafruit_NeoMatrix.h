@@ -0,0 +1,139 @@
+// Host stand-in of Adafruit_NeoMatrix for pio test -e native: a single matrix without tiles and rotation. HostFrame
+// turns a show() of the strip back into x, y for comparing and viewing the frames.
+#pragma once
+
+#include <stdio.h>
+#include "Adafruit_GFX.h"
+#include "Adafruit_NeoPixel.h"
+
+#define NEO_MATRIX_TOP 0x00
+#define NEO_MATRIX_BOTTOM 0x01
+#define NEO_MATRIX_LEFT 0x00
+#define NEO_MATRIX_RIGHT 0x02
+#define NEO_MATRIX_CORNER 0x03
+#define NEO_MATRIX_ROWS 0x00
+#define NEO_MATRIX_COLUMNS 0x04
+#define NEO_MATRIX_AXIS 0x04
+#define NEO_MATRIX_PROGRESSIVE 0x00
+#define NEO_MATRIX_ZIGZAG 0x08
+#define NEO_MATRIX_SEQUENCE 0x08
+
+class Adafruit_NeoMatrix : public Adafruit_GFX, public Adafruit_NeoPixel {
+  public:
+    Adafruit_NeoMatrix(int w, int h, uint8_t pin = 6, uint8_t matrixType = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS,
+                       neoPixelType ledType = NEO_GRB + NEO_KHZ800)
+      : Adafruit_GFX(w, h), Adafruit_NeoPixel(w * h, pin, ledType), type(matrixType) {}
+
+    // RGB565
+    static uint16_t Color(uint8_t r, uint8_t g, uint8_t b) {
+      return ((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | (b >> 3);
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) {
+      if (x < 0 || y < 0 || x >= _width || y >= _height) {
+        return;
+      }
+      setPixelColor(ledIndex(x, y), expandColor(color));
+    }
+
+    void fillScreen(uint16_t color) {
+      fill(expandColor(color));
+    }
+
+    // LED of x, y with the layout rules of the library
+    uint16_t ledIndex(int16_t x, int16_t y) const {
+      bool columns = (type & NEO_MATRIX_AXIS) == NEO_MATRIX_COLUMNS;
+      int16_t major = columns ? x : y;
+      int16_t minor = columns ? y : x;
+      int16_t majorSize = columns ? _width : _height;
+      int16_t minorSize = columns ? _height : _width;
+      if (type & (columns ? NEO_MATRIX_RIGHT : NEO_MATRIX_BOTTOM)) {
+        major = majorSize - 1 - major;
+      }
+      if (type & (columns ? NEO_MATRIX_BOTTOM : NEO_MATRIX_RIGHT)) {
+        minor = minorSize - 1 - minor;
+      }
+      if ((type & NEO_MATRIX_SEQUENCE) == NEO_MATRIX_ZIGZAG && (major & 1)) {
+        minor = minorSize - 1 - minor;
+      }
+      return major * minorSize + minor;
+    }
+
+    // 0xRRGGBB of a LED in pixels in the order of the strip
+    uint32_t ledColor(const uint8_t *pixels, uint16_t led) const {
+      const uint8_t *p = pixels + led * 3;
+      return ((uint32_t)p[rOffset] << 16) | ((uint32_t)p[gOffset] << 8) | p[bOffset];
+    }
+
+  private:
+    uint8_t type;
+
+    // gamma 2.5 in place of the tables of the library: the host frames are close to the LEDs, not bit exact
+    static uint32_t expandColor(uint16_t color) {
+      static uint8_t gamma5[32], gamma6[64];
+      if (gamma6[63] == 0) {
+        for (int i = 0; i < 64; i++) {
+          if (i < 32) {
+            gamma5[i] = (uint8_t)(pow(i / 31.0, 2.5) * 255 + 0.5);
+          }
+          gamma6[i] = (uint8_t)(pow(i / 63.0, 2.5) * 255 + 0.5);
+        }
+      }
+      return ((uint32_t)gamma5[color >> 11] << 16) | ((uint32_t)gamma6[(color >> 5) & 0x3F] << 8) | gamma5[color & 0x1F];
+    }
+};
+
+// a show() of a matrix as x, y: the colors which the LEDs get (0xRRGGBB) row by row, with the time of the show()
+class HostFrame {
+  public:
+    HostFrame(const Adafruit_NeoMatrix &matrix, const HostShow &show)
+      : time(show.time), width(matrix.width()), height(matrix.height()), pixels(width * height) {
+      for (int16_t y = 0; y < height; y++) {
+        for (int16_t x = 0; x < width; x++) {
+          pixels[y * width + x] = matrix.ledColor(show.pixels.data(), matrix.ledIndex(x, y));
+        }
+      }
+    }
+
+    uint64_t time; // us
+    int16_t width;
+    int16_t height;
+    std::vector<uint32_t> pixels;
+
+    uint32_t pixel(int16_t x, int16_t y) const { return pixels[y * width + x]; }
+
+    // FNV-1a over the pixels: frames can be compared with golden ones without storing them
+    uint32_t hash() const {
+      uint32_t hash = 2166136261UL;
+      for (uint32_t color : pixels) {
+        for (int shift = 16; shift >= 0; shift -= 8) {
+          hash = (hash ^ (uint8_t)(color >> shift)) * 16777619UL;
+        }
+      }
+      return hash;
+    }
+
+    // binary PPM (P6), scale pixels per LED
+    void writePpm(FILE *file, int scale = 1) const {
+      fprintf(file, "P6\n%d %d\n255\n", width * scale, height * scale);
+      for (int row = 0; row < height * scale; row++) {
+        for (int column = 0; column < width * scale; column++) {
+          uint32_t color = pixel(column / scale, row / scale);
+          uint8_t rgb[3] = { (uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color };
+          fwrite(rgb, 1, 3, file);
+        }
+      }
+    }
+
+    // two blanks with a 24 bit background color per LED, for a terminal
+    void writeAnsi(FILE *file) const {
+      for (int16_t y = 0; y < height; y++) {
+        for (int16_t x = 0; x < width; x++) {
+          uint32_t color = pixel(x, y);
+          fprintf(file, "\x1b[48;2;%u;%u;%um  ", (unsigned)(color >> 16), (unsigned)(color >> 8) & 0xFF,
+                  (unsigned)color & 0xFF);
+        }
+        fprintf(file, "\x1b[0m\n");
+      }
+    }
+};
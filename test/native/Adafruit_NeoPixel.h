@@ -0,0 +1,171 @@
+// Host stand-in of Adafruit_NeoPixel for pio test -e native: show() records the pixels with the time, see hostShows()
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include "Arduino.h"
+
+// pixel types: the offsets of red, green and blue in the bytes of a pixel
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_RBG ((0 << 6) | (0 << 4) | (2 << 2) | (1))
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_GBR ((2 << 6) | (2 << 4) | (0 << 2) | (1))
+#define NEO_BRG ((1 << 6) | (1 << 4) | (2 << 2) | (0))
+#define NEO_BGR ((2 << 6) | (2 << 4) | (1 << 2) | (0))
+#define NEO_KHZ800 0x0000
+#define NEO_KHZ400 0x0100
+
+typedef uint16_t neoPixelType;
+
+// a show() of a strip: the virtual time in us and a copy of its pixels in the order of the strip
+struct HostShow {
+  uint64_t time;
+  int16_t pin;
+  std::vector<uint8_t> pixels;
+};
+
+// the shows of all strips since the start or the last clear(), in the order of the calls
+inline std::vector<HostShow> &hostShows() {
+  static std::vector<HostShow> shows;
+  return shows;
+}
+
+inline std::mutex &hostShowsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// only RGB strips: the same pixel layout and brightness scaling as the library
+class Adafruit_NeoPixel {
+  public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, neoPixelType type = NEO_GRB + NEO_KHZ800)
+      : numLEDs(n), numBytes(n * 3), pin(pin), pixels(new uint8_t[n * 3]()) {
+      rOffset = (type >> 4) & 3;
+      gOffset = (type >> 2) & 3;
+      bOffset = type & 3;
+    }
+
+    Adafruit_NeoPixel(const Adafruit_NeoPixel &) = delete;
+    virtual ~Adafruit_NeoPixel() { delete[] pixels; }
+
+    void begin() {}
+
+    void show() {
+      std::lock_guard<std::mutex> lock(hostShowsMutex());
+      hostShows().push_back({ hostMicros(), pin, std::vector<uint8_t>(pixels, pixels + numBytes) });
+    }
+
+    bool canShow() { return true; }
+
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+      if (n >= numLEDs) {
+        return;
+      }
+      if (brightness) { // see setBrightness()
+        r = (r * brightness) >> 8;
+        g = (g * brightness) >> 8;
+        b = (b * brightness) >> 8;
+      }
+      uint8_t *p = &pixels[n * 3];
+      p[rOffset] = r;
+      p[gOffset] = g;
+      p[bOffset] = b;
+    }
+
+    void setPixelColor(uint16_t n, uint32_t c) {
+      setPixelColor(n, (uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+    }
+
+    void fill(uint32_t c = 0, uint16_t first = 0, uint16_t count = 0) {
+      uint16_t end = (count == 0 || first + count > numLEDs) ? numLEDs : first + count;
+      for (uint16_t i = first; i < end; i++) {
+        setPixelColor(i, c);
+      }
+    }
+
+    void clear() { memset(pixels, 0, numBytes); }
+
+    // the brightness is stored + 1, so 0 = full brightness, and the pixels which are already set are scaled
+    void setBrightness(uint8_t b) {
+      uint8_t newBrightness = b + 1;
+      if (newBrightness != brightness) {
+        uint8_t oldBrightness = brightness - 1;
+        uint16_t scale;
+        if (oldBrightness == 0) {
+          scale = 0;
+        } else if (b == 255) {
+          scale = 65535 / oldBrightness;
+        } else {
+          scale = (((uint16_t)newBrightness << 8) - 1) / oldBrightness;
+        }
+        for (uint16_t i = 0; i < numBytes; i++) {
+          pixels[i] = (pixels[i] * scale) >> 8;
+        }
+        brightness = newBrightness;
+      }
+    }
+
+    uint8_t getBrightness() const { return brightness - 1; }
+    uint8_t *getPixels() const { return pixels; }
+    uint16_t numPixels() const { return numLEDs; }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+      return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+    static uint32_t ColorHSV(uint16_t hue, uint8_t sat = 255, uint8_t val = 255) {
+      uint8_t r, g, b;
+      hue = (hue * 1530L + 32768) / 65536;
+      if (hue < 510) {
+        b = 0;
+        if (hue < 255) { r = 255; g = hue; } else { r = 510 - hue; g = 255; }
+      } else if (hue < 1020) {
+        r = 0;
+        if (hue < 765) { g = 255; b = hue - 510; } else { g = 1020 - hue; b = 255; }
+      } else if (hue < 1530) {
+        g = 0;
+        if (hue < 1275) { r = hue - 1020; b = 255; } else { r = 255; b = 1530 - hue; }
+      } else {
+        r = 255;
+        g = b = 0;
+      }
+      uint32_t v1 = 1 + val;
+      uint16_t s1 = 1 + sat;
+      uint8_t s2 = 255 - sat;
+      return ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) | (((((g * s1) >> 8) + s2) * v1) & 0xff00) |
+             (((((b * s1) >> 8) + s2) * v1) >> 8);
+    }
+
+    // gamma 2.6 like the table of the library
+    static uint8_t gamma8(uint8_t x) { return (uint8_t)(pow(x / 255.0, 2.6) * 255 + 0.5); }
+
+    static uint32_t gamma32(uint32_t x) {
+      uint32_t result = 0;
+      for (int shift = 0; shift < 32; shift += 8) {
+        result |= (uint32_t)gamma8(x >> shift) << shift;
+      }
+      return result;
+    }
+
+    void rainbow(uint16_t first_hue = 0, int8_t reps = 1, uint8_t saturation = 255, uint8_t brightness = 255,
+                 bool gammify = true) {
+      for (uint16_t i = 0; i < numLEDs; i++) {
+        uint16_t hue = first_hue + (i * reps * 65536) / numLEDs;
+        uint32_t color = ColorHSV(hue, saturation, brightness);
+        if (gammify) {
+          color = gamma32(color);
+        }
+        setPixelColor(i, color);
+      }
+    }
+
+  protected:
+    uint16_t numLEDs;
+    uint16_t numBytes;
+    int16_t pin;
+    uint8_t *pixels;
+    uint8_t brightness = 0;
+    uint8_t rOffset;
+    uint8_t gOffset;
+    uint8_t bOffset;
+};
@@ -0,0 +1,91 @@
+// Host stand-in of the Arduino core for pio test -e native: the time is virtual, see hostMicros()
+#pragma once
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+using std::max;
+using std::min;
+
+#define IRAM_ATTR
+#define PI 3.1415926535897932384626433832795
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline unsigned long micros() { return hostMicros(); }
+inline unsigned long millis() { return hostMicros() / 1000; }
+inline void delay(unsigned long ms) { hostMicros() += ms * 1000ULL; }
+inline void delayMicroseconds(unsigned int us) { hostMicros() += us; }
+
+// the same numbers in every run
+inline long random(long howbig) { return howbig <= 0 ? 0 : rand() % howbig; }
+inline long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+inline void randomSeed(unsigned long seed) { srand(seed); }
+
+// there are no pins: the buttons are pressed by calling their interrupt service routines
+#define INPUT 0x01
+#define RISING 0x01
+inline void pinMode(uint8_t pin, uint8_t mode) {}
+inline void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {}
+
+class String : public std::string {
+  public:
+    using std::string::string;
+    String() {}
+    String(const std::string &text) : std::string(text) {}
+};
+
+// the text of all print functions goes through write()
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(const uint8_t *data, size_t size) = 0;
+
+    size_t print(const char *text) { return write((const uint8_t *)text, strlen(text)); }
+    size_t print(const std::string &text) { return print(text.c_str()); }
+    size_t print(char c) { return write((const uint8_t *)&c, 1); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(int value) { return print((long)value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+    size_t print(unsigned int value) { return print((unsigned long)value); }
+    size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+
+    template <typename T> size_t println(T value) { return print(value) + println(); }
+    size_t println() { return print("\r\n"); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+      char text[512];
+      va_list arguments;
+      va_start(arguments, format);
+      int len = vsnprintf(text, sizeof(text), format, arguments);
+      va_end(arguments);
+      return write((const uint8_t *)text, std::min((size_t)len, sizeof(text) - 1));
+    }
+};
+
+// the serial port writes to stdout, or into text while it is captured
+class HardwareSerial : public Print {
+  public:
+    bool isCaptured = false;
+    std::string text;
+
+    void begin(unsigned long baud) {}
+
+    size_t write(const uint8_t *data, size_t size) {
+      if (isCaptured) {
+        text.append((const char *)data, size);
+      } else {
+        fwrite(data, 1, size, stdout);
+      }
+      return size;
+    }
+};
+
+inline HardwareSerial Serial;
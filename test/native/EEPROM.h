@@ -0,0 +1,57 @@
+// Host stand-in of the EEPROM library for pio test -e native: the bytes are in RAM and start erased
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "Arduino.h"
+
+class EEPROMClass {
+  public:
+    bool begin(size_t size) {
+      bytes.resize(size, 0xFF);
+      return true;
+    }
+
+    uint8_t read(int address) { return (size_t)address < bytes.size() ? bytes[address] : 0; }
+
+    void write(int address, uint8_t value) {
+      if ((size_t)address < bytes.size()) {
+        bytes[address] = value;
+      }
+    }
+
+    template <typename T> T &get(int address, T &t) {
+      memcpy(&t, bytes.data() + address, sizeof(T));
+      return t;
+    }
+
+    template <typename T> const T &put(int address, const T &t) {
+      memcpy(bytes.data() + address, &t, sizeof(T));
+      return t;
+    }
+
+    bool commit() {
+      commits++;
+      if (onCommit) {
+        onCommit();
+      }
+      if (failCommits > 0) {
+        failCommits--;
+        return false;
+      }
+      return true;
+    }
+
+    uint8_t *getDataPtr() { return bytes.data(); }
+    uint16_t length() { return bytes.size(); }
+
+    // host only
+    uint32_t commits = 0;              // the calls of commit(), also the failed ones
+    uint32_t failCommits = 0;          // the next commits fail
+    std::function<void()> onCommit;    // called in each commit, e.g. to change the settings from "the other core"
+
+  private:
+    std::vector<uint8_t> bytes;
+};
+
+inline EEPROMClass EEPROM;
@@ -0,0 +1,32 @@
+// Host stand-in of WiFi.h for pio test -e native: there is never a connection
+#pragma once
+
+#include <time.h>
+#include "Arduino.h"
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+class Client {};
+
+class WiFiClient : public Client {};
+
+class WiFiClass {
+  public:
+    wl_status_t begin(const char *ssid, const char *passphrase = NULL) { return WL_DISCONNECTED; }
+    bool disconnect() { return true; }
+    wl_status_t status() { return WL_DISCONNECTED; }
+};
+
+inline WiFiClass WiFi;
+
+inline void configTime(long gmtOffset_sec, int daylightOffset_sec, const char *server1) {}
+
+inline bool getLocalTime(struct tm *info, uint32_t ms = 5000) {
+  return false;
+}
@@ -0,0 +1,57 @@
+// Host stand-in of the RMT driver for pio test -e native: the items of the last write of a channel are kept and are
+// out at once, see hostRmtItems()
+#pragma once
+
+#include <vector>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef enum {
+  RMT_CHANNEL_0 = 0,
+  RMT_CHANNEL_1,
+  RMT_CHANNEL_2,
+  RMT_CHANNEL_3,
+  RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef int gpio_num_t;
+
+typedef struct {
+  union {
+    struct {
+      uint32_t duration0 : 15;
+      uint32_t level0 : 1;
+      uint32_t duration1 : 15;
+      uint32_t level1 : 1;
+    };
+    uint32_t val;
+  };
+} rmt_item32_t;
+
+typedef struct {
+  int rmt_mode;
+  rmt_channel_t channel;
+  gpio_num_t gpio_num;
+  uint8_t clk_div;
+  uint8_t mem_block_num;
+} rmt_config_t;
+
+#define RMT_DEFAULT_CONFIG_TX(gpio, channel_id) { 0, channel_id, gpio, 80, 1 }
+
+inline std::vector<rmt_item32_t> &hostRmtItems(rmt_channel_t channel) {
+  static std::vector<rmt_item32_t> items[RMT_CHANNEL_MAX];
+  return items[channel];
+}
+
+inline esp_err_t rmt_config(const rmt_config_t *config) {
+  return config->channel < RMT_CHANNEL_MAX ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+inline esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rx_buf_size, int intr_alloc_flags) { return ESP_OK; }
+
+inline esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t *items, int item_num, bool wait_tx_done) {
+  hostRmtItems(channel).assign(items, items + item_num);
+  return ESP_OK;
+}
+
+inline esp_err_t rmt_wait_tx_done(rmt_channel_t channel, TickType_t wait_time) { return ESP_OK; }
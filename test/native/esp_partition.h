@@ -0,0 +1,89 @@
+// Host stand-in of esp_partition.h for pio test -e native: the data partitions are in RAM and are added by the test
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include "esp_err.h"
+
+#define SPI_FLASH_SEC_SIZE 4096
+
+typedef enum {
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+  ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+  uint8_t *memory;     // host only
+  uint32_t failWrites; // host only: the next writes fail
+  uint32_t erases;     // host only
+} esp_partition_t;
+
+inline std::map<std::string, esp_partition_t> &hostPartitions() {
+  static std::map<std::string, esp_partition_t> partitions;
+  return partitions;
+}
+
+// adds an erased data partition (or erases it again) and returns its bytes
+inline uint8_t *hostAddPartition(const char *label, uint32_t size) {
+  esp_partition_t &partition = hostPartitions()[label];
+  delete[] partition.memory;
+  partition.type = ESP_PARTITION_TYPE_DATA;
+  partition.subtype = ESP_PARTITION_SUBTYPE_ANY;
+  partition.address = 0;
+  partition.size = size;
+  strncpy(partition.label, label, sizeof(partition.label) - 1);
+  partition.memory = new uint8_t[size];
+  partition.failWrites = 0;
+  partition.erases = 0;
+  memset(partition.memory, 0xFF, size);
+  return partition.memory;
+}
+
+inline const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                        const char *label) {
+  auto found = hostPartitions().find(label);
+  return found == hostPartitions().end() || found->second.type != type ? nullptr : &found->second;
+}
+
+inline esp_err_t esp_partition_read(const esp_partition_t *partition, size_t offset, void *data, size_t size) {
+  if (offset + size > partition->size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  memcpy(data, partition->memory + offset, size);
+  return ESP_OK;
+}
+
+// like NOR flash: a write can only clear bits
+inline esp_err_t esp_partition_write(const esp_partition_t *partition, size_t offset, const void *data, size_t size) {
+  if (offset + size > partition->size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  if (partition->failWrites > 0) {
+    const_cast<esp_partition_t *>(partition)->failWrites--;
+    return ESP_FAIL;
+  }
+  for (size_t i = 0; i < size; i++) {
+    partition->memory[offset + i] &= ((const uint8_t *)data)[i];
+  }
+  return ESP_OK;
+}
+
+inline esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size) {
+  if (offset % SPI_FLASH_SEC_SIZE != 0 || size % SPI_FLASH_SEC_SIZE != 0 || offset + size > partition->size) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memset(partition->memory + offset, 0xFF, size);
+  const_cast<esp_partition_t *>(partition)->erases++;
+  return ESP_OK;
+}
@@ -0,0 +1,46 @@
+// Host stand-in of FreeRTOS for pio test -e native: 1 tick is 1 ms like in the firmware
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xffffffffUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configMAX_PRIORITIES 25
+#define portYIELD_FROM_ISR() do {} while (0)
+
+// the virtual time of the host in us: the clock of micros() and millis(), it only moves with delay() and with the
+// waits of a task in virtual time, see task.h
+inline std::atomic<uint64_t> &hostMicros() {
+  static std::atomic<uint64_t> us(0);
+  return us;
+}
+
+// the critical sections are spin locks like on the ESP32, there are no interrupts to disable
+struct portMUX_TYPE {
+  std::atomic<bool> locked{false};
+};
+#define portMUX_INITIALIZER_UNLOCKED {}
+
+inline void portENTER_CRITICAL(portMUX_TYPE *mux) {
+  while (mux->locked.exchange(true, std::memory_order_acquire)) {
+  }
+}
+
+inline void portEXIT_CRITICAL(portMUX_TYPE *mux) {
+  mux->locked.store(false, std::memory_order_release);
+}
+
+inline void portENTER_CRITICAL_ISR(portMUX_TYPE *mux) { portENTER_CRITICAL(mux); }
+inline void portEXIT_CRITICAL_ISR(portMUX_TYPE *mux) { portEXIT_CRITICAL(mux); }
+
+inline BaseType_t xPortGetCoreID() { return 0; }
@@ -0,0 +1,93 @@
+// Host stand-in of the FreeRTOS tasks for pio test -e native: a task is a std::thread with a notification counter.
+// A task in virtual time never sleeps: a wait which runs into its timeout moves the virtual clock on instead.
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "freertos/FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+
+struct HostTask {
+  std::mutex mutex;
+  std::condition_variable notified;
+  uint32_t notifications = 0;
+  bool virtualTime = false;
+};
+typedef HostTask *TaskHandle_t;
+
+// the task of the calling thread: the main thread gets one when it asks for it
+inline TaskHandle_t &hostCurrentTask() {
+  static thread_local TaskHandle_t task = nullptr;
+  return task;
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+  if (hostCurrentTask() == nullptr) {
+    hostCurrentTask() = new HostTask();
+  }
+  return hostCurrentTask();
+}
+
+// the handles are never freed: like on FreeRTOS a late notification of a deleted task must not crash
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack, void *parameter,
+                                          UBaseType_t priority, TaskHandle_t *handle, BaseType_t core) {
+  TaskHandle_t task = new HostTask();
+  if (handle != nullptr) {
+    *handle = task;
+  }
+  std::thread([=]() {
+    hostCurrentTask() = task;
+    function(parameter);
+  }).detach();
+  return pdPASS;
+}
+
+inline BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stack, void *parameter,
+                              UBaseType_t priority, TaskHandle_t *handle) {
+  return xTaskCreatePinnedToCore(function, name, stack, parameter, priority, handle, 0);
+}
+
+// the function of the task returns right after it: the thread ends there
+inline void vTaskDelete(TaskHandle_t task) {}
+
+inline void vTaskDelay(TickType_t ticks) {
+  if (xTaskGetCurrentTaskHandle()->virtualTime) {
+    hostMicros() += ticks * 1000ULL;
+  } else {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+  }
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  std::lock_guard<std::mutex> lock(task->mutex);
+  task->notifications++;
+  task->notified.notify_one();
+  return pdPASS;
+}
+
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken) {
+  xTaskNotifyGive(task);
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(task->mutex);
+  auto hasNotifications = [task]() { return task->notifications > 0; };
+  if (ticks == portMAX_DELAY) {
+    task->notified.wait(lock, hasNotifications);
+  } else if (task->virtualTime) {
+    if (!hasNotifications()) {
+      hostMicros() += ticks * 1000ULL;
+    }
+  } else {
+    task->notified.wait_for(lock, std::chrono::milliseconds(ticks), hasNotifications);
+  }
+  uint32_t result = task->notifications;
+  if (result > 0) {
+    task->notifications = clearOnExit ? 0 : result - 1;
+  }
+  return result;
+}
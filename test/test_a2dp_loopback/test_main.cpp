@@ -0,0 +1,149 @@
+// Host test of A2DPLoopback and a comparison of sink buffer settings: run with pio test -e native -v
+#include <unity.h>
+#include "A2DPLoopback.h"
+
+static uint32_t source_frame;   // next frame of the source
+static uint32_t sink_frame;     // next frame which the sink expects
+static uint32_t sink_gaps;      // packets which did not start with the expected frame
+static bool source_is_empty;
+
+void setUp(void) {
+    source_frame = 0;
+    sink_frame = 0;
+    sink_gaps = 0;
+    source_is_empty = false;
+}
+
+void tearDown(void) {}
+
+// frames which contain their number, so that the sink can check the order
+static int32_t source(uint8_t *data, int32_t len) {
+    if (source_is_empty) {
+        return 0;
+    }
+    uint16_t *samples = (uint16_t*) data;
+    for (int32_t j = 0; j < len / 4; j++) {
+        samples[2 * j] = source_frame & 0xFFFF;
+        samples[2 * j + 1] = source_frame >> 16;
+        source_frame++;
+    }
+    return len;
+}
+
+static void sink(const uint8_t *data, uint32_t len) {
+    const uint16_t *samples = (const uint16_t*) data;
+    uint32_t first = samples[0] | (samples[1] << 16);
+    if (first != sink_frame) {
+        sink_gaps++;
+    }
+    for (uint32_t j = 0; j < len / 4; j++) {
+        TEST_ASSERT_EQUAL(first + j, samples[2 * j] | (samples[2 * j + 1] << 16));
+    }
+    sink_frame = first + len / 4;
+}
+
+static void silent_sink(const uint8_t *data, uint32_t len) {
+    for (uint32_t j = 0; j < len; j++) {
+        TEST_ASSERT_EQUAL(0, data[j]);
+    }
+    sink_frame += len / 4;
+}
+
+static a2dp_loopback_config_t ideal_link() {
+    a2dp_loopback_config_t config;
+    config.frames_variation = 0;
+    config.jitter_ms = 0;
+    config.loss_enter = 0;
+    config.skew_ppm = 0;
+    return config;
+}
+
+void test_ideal_link_has_no_glitches(void) {
+    A2DPLoopback loopback(source, sink, ideal_link());
+    a2dp_loopback_stats_t stats = loopback.run(10000);
+    TEST_ASSERT_EQUAL(0, stats.glitches());
+    TEST_ASSERT_EQUAL(0, sink_gaps);
+    TEST_ASSERT_EQUAL(source_frame, stats.frames_delivered);
+    TEST_ASSERT_EQUAL(source_frame, sink_frame);
+    TEST_ASSERT_EQUAL((10 * 44100 + 639) / 640, stats.packets);
+    // the link latency plus the buffered frames: the 5th packet of 14.5 ms completes the prefill of 60 ms, then
+    // 4 packets are in the buffer when the next one arrives
+    TEST_ASSERT_FLOAT_WITHIN(0.5, 20 + 4 * 640 * 1000.0 / 44100, stats.latency_avg_ms);
+}
+
+void test_lost_packets_are_not_delivered(void) {
+    a2dp_loopback_config_t config = ideal_link();
+    config.loss_enter = 0.05;
+    config.loss_leave = 0.5;
+    A2DPLoopback loopback(source, sink, config);
+    a2dp_loopback_stats_t stats = loopback.run(60000);
+    TEST_ASSERT_TRUE(stats.packets_lost > 0);
+    // a burst of lost packets leaves one gap
+    TEST_ASSERT_TRUE(sink_gaps > 0 && sink_gaps <= stats.packets_lost);
+    TEST_ASSERT_EQUAL(source_frame - 640 * stats.packets_lost, stats.frames_delivered);
+}
+
+void test_clock_skew_underruns_and_overflows(void) {
+    a2dp_loopback_config_t config = ideal_link();
+    config.skew_ppm = 2000;
+    A2DPLoopback fast_sink(source, sink, config);
+    a2dp_loopback_stats_t stats = fast_sink.run(120000);
+    TEST_ASSERT_TRUE(stats.underruns > 0);
+    TEST_ASSERT_EQUAL(0, stats.overflows);
+
+    config.skew_ppm = -2000;
+    A2DPLoopback slow_sink(source, sink, config);
+    stats = slow_sink.run(120000);
+    TEST_ASSERT_EQUAL(0, stats.underruns);
+    TEST_ASSERT_TRUE(stats.overflows > 0);
+}
+
+void test_runs_are_reproducible(void) {
+    a2dp_loopback_config_t config;
+    A2DPLoopback loopback(source, sink, config);
+    a2dp_loopback_stats_t first = loopback.run(30000);
+    a2dp_loopback_stats_t second = loopback.run(30000);
+    TEST_ASSERT_EQUAL_MEMORY(&first, &second, sizeof(first));
+    config.seed = 2;
+    A2DPLoopback other(source, sink, config);
+    a2dp_loopback_stats_t third = other.run(30000);
+    TEST_ASSERT_TRUE(memcmp(&first, &third, sizeof(first)) != 0);
+}
+
+void test_empty_source_sends_silence(void) {
+    source_is_empty = true;
+    A2DPLoopback loopback(source, silent_sink, ideal_link());
+    a2dp_loopback_stats_t stats = loopback.run(1000);
+    TEST_ASSERT_EQUAL(stats.frames_delivered, sink_frame);
+    TEST_ASSERT_TRUE(stats.frames_delivered >= 44100);
+}
+
+// the trade-off between glitches and latency for the default link
+void test_compare_sink_buffers(void) {
+    const uint32_t prefills[] = {20, 60, 120};
+    const float skews[] = {-100, 0, 100};
+    for (uint32_t prefill : prefills) {
+        for (float skew : skews) {
+            a2dp_loopback_config_t config;
+            config.prefill_ms = prefill;
+            config.skew_ppm = skew;
+            A2DPLoopback loopback(source, sink, config);
+            a2dp_loopback_stats_t stats = loopback.run(600000);
+            char message[160];
+            snprintf(message, sizeof(message), "prefill %3u ms skew %+4.0f ppm: lost %u underruns %u overflows %u latency avg %.1f ms max %.1f ms",
+                prefill, skew, stats.packets_lost, stats.underruns, stats.overflows, stats.latency_avg_ms, stats.latency_max_ms);
+            TEST_MESSAGE(message);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ideal_link_has_no_glitches);
+    RUN_TEST(test_lost_packets_are_not_delivered);
+    RUN_TEST(test_clock_skew_underruns_and_overflows);
+    RUN_TEST(test_runs_are_reproducible);
+    RUN_TEST(test_empty_source_sends_silence);
+    RUN_TEST(test_compare_sink_buffers);
+    return UNITY_END();
+}
@@ -0,0 +1,283 @@
+// Host test of the animation format and AnimationPlayer: frame by frame decoding against decoding from the first frame,
+// a round trip of heart through the encoder and a benchmark of the cost and the size per frame.
+// Run with pio test -e native -v
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include <Arduino.h>
+#include "images.h"
+#include "ledmap.h"
+#include "animation.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const size_t frameSize = MATRIX_WIDTH * MATRIX_HEIGHT * 3;
+
+static std::vector<uint8_t> leds() {
+    return std::vector<uint8_t>(matrix.getPixels(), matrix.getPixels() + frameSize);
+}
+
+// encodeFrame() of img/golang_img_to_neomatrix: previous is empty for the first frame
+static std::vector<uint8_t> encodeFrame(const std::vector<uint8_t> &indices, const std::vector<uint8_t> &previous) {
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < indices.size();) {
+        size_t n = 1;
+        if (!previous.empty() && indices[i] == previous[i]) {
+            while (i + n < indices.size() && n < 128 && indices[i + n] == previous[i + n]) {
+                n++;
+            }
+            data.push_back(0x80 + n - 1);
+        } else {
+            while (i + n < indices.size() && n < 128 && indices[i + n] == indices[i]
+                   && (previous.empty() || indices[i + n] != previous[i + n])) {
+                n++;
+            }
+            data.push_back(n - 1);
+            data.push_back(indices[i]);
+        }
+        i += n;
+    }
+    return data;
+}
+
+// the palette indices of a frame, decoded on top of the indices of the previous frame
+static void decodeIndices(const animation &anim, int frame, std::vector<uint8_t> &indices) {
+    const uint8_t *data = anim.data + anim.frames[frame];
+    int size = anim.width * anim.height;
+    for (int pos = 0; pos < size;) {
+        uint8_t run = *data++;
+        int length = (run & 0x7F) + 1;
+        if (run & 0x80) {
+            pos += length;
+            continue;
+        }
+        uint8_t index = *data++;
+        for (int end = min(pos + length, size); pos < end; pos++) {
+            indices[pos] = index;
+        }
+    }
+}
+
+// bytes of the runs of a frame
+static int frameBytes(const animation &anim, int frame) {
+    const uint8_t *data = anim.data + anim.frames[frame];
+    const uint8_t *p = data;
+    for (int pos = 0; pos < anim.width * anim.height;) {
+        uint8_t run = *p++;
+        pos += (run & 0x7F) + 1;
+        if (!(run & 0x80)) {
+            p++;
+        }
+    }
+    return p - data;
+}
+
+// an animation which is encoded like the generator does it, with the indices of its frames
+class TestClip {
+  public:
+    std::vector<std::vector<uint8_t>> indices;
+    std::vector<uint16_t> offsets;
+    std::vector<uint8_t> data;
+    animation anim;
+
+    TestClip(uint8_t width, uint8_t height, const uint16_t *palette, const std::vector<std::vector<uint8_t>> &frames)
+      : indices(frames) {
+      for (size_t i = 0; i < frames.size(); i++) {
+        offsets.push_back(data.size());
+        std::vector<uint8_t> frame = encodeFrame(frames[i], i == 0 ? std::vector<uint8_t>() : frames[i - 1]);
+        data.insert(data.end(), frame.begin(), frame.end());
+      }
+      anim = { width, height, (uint8_t)frames.size(), 100, palette, offsets.data(), data.data() };
+    }
+
+    // anim points into the vectors
+    TestClip(const TestClip &) = delete;
+};
+
+static const uint16_t clipPalette[16] = {
+  0x0000, 0xF800, 0x07E0, 0x001F, 0xFFE0, 0xF81F, 0x07FF, 0xFFFF,
+  0x8000, 0x0400, 0x0010, 0x8400, 0x8010, 0x0410, 0x8410, 0xC618
+};
+
+// 32x8 frames which cover all kinds of runs: paint runs of 128, frames in which every pixel changes with runs of 1,
+// a frame without changes (skip runs of 128) and one in which only a part changes
+static TestClip makeClip() {
+    const int size = MATRIX_WIDTH * MATRIX_HEIGHT;
+    std::vector<std::vector<uint8_t>> frames;
+    frames.push_back(std::vector<uint8_t>(size, 3));
+    frames.push_back(std::vector<uint8_t>(size, 5));
+    std::vector<uint8_t> frame(size);
+    for (int i = 0; i < size; i++) {
+        frame[i] = 6 + i % 10; // never 5: every pixel changes
+    }
+    frames.push_back(frame);
+    for (int k = 0; k < 7; k++) {
+        for (uint8_t &index : frame) {
+            index = (index + 1) % 16;
+        }
+        frames.push_back(frame);
+    }
+    frames.push_back(frame);
+    for (int i = 0; i < 100; i++) {
+        frame[i] = (frame[i] + 1) % 16;
+    }
+    frames.push_back(frame);
+    frames.push_back(std::vector<uint8_t>(size, 0));
+    return TestClip(MATRIX_WIDTH, MATRIX_HEIGHT, clipPalette, frames);
+}
+
+// the LEDs of the frame drawn from its indices
+static std::vector<uint8_t> expectedLeds(const animation &anim, const std::vector<uint8_t> &indices) {
+    ledMap.fill(0);
+    for (size_t pos = 0; pos < indices.size(); pos++) {
+        ledMap.pixel(pos % anim.width, pos / anim.width, anim.palette[indices[pos]]);
+    }
+    return leds();
+}
+
+// the LEDs of each frame when it is decoded from the first frame on
+static std::vector<std::vector<uint8_t>> fromFirstFrame(const animation &anim) {
+    std::vector<std::vector<uint8_t>> result;
+    for (int frame = 0; frame < anim.frameCount; frame++) {
+        ledMap.fill(0);
+        AnimationPlayer player(anim);
+        player.draw(frame * anim.frameDuration);
+        result.push_back(leds());
+    }
+    return result;
+}
+
+static void assertFrameByFrame(const animation &anim) {
+    std::vector<std::vector<uint8_t>> expected = fromFirstFrame(anim);
+    ledMap.fill(0);
+    AnimationPlayer player(anim);
+    // two rounds: the second one starts again at frame 0 on top of the last frame
+    for (int round = 0; round < 2; round++) {
+        for (int frame = 0; frame < anim.frameCount; frame++) {
+            unsigned long now = (round * anim.frameCount + frame) * anim.frameDuration;
+            player.draw(now);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected[frame].data(), leds().data(), frameSize);
+            // the same frame again does not draw anything: a pixel of the animation which we change stays
+            ledMap.pixel(0, 0, 0x1234);
+            std::vector<uint8_t> changed = leds();
+            player.draw(now + anim.frameDuration - 1);
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(changed.data(), leds().data(), frameSize);
+            memcpy(matrix.getPixels(), expected[frame].data(), frameSize);
+        }
+    }
+}
+
+void test_heart_frame_by_frame_is_like_from_the_first_frame(void) {
+    assertFrameByFrame(heart);
+}
+
+void test_heart_is_what_the_generator_makes(void) {
+    // the indices of the frames, encoded again
+    std::vector<uint8_t> indices(heart.width * heart.height), previous;
+    std::vector<uint8_t> data;
+    for (int frame = 0; frame < heart.frameCount; frame++) {
+        TEST_ASSERT_EQUAL(data.size(), heart.frames[frame]);
+        decodeIndices(heart, frame, indices);
+        std::vector<uint8_t> encoded = encodeFrame(indices, previous);
+        data.insert(data.end(), encoded.begin(), encoded.end());
+        previous = indices;
+    }
+    TEST_ASSERT_EQUAL(sizeof(heartData), data.size());
+    TEST_ASSERT_EQUAL(sizeof(heartData), heart.frames[heart.frameCount - 1] + frameBytes(heart, heart.frameCount - 1));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(heartData, data.data(), data.size());
+}
+
+void test_clip_covers_all_runs(void) {
+    TestClip clip = makeClip();
+    const std::vector<uint8_t> &data = clip.data;
+    // a paint run of 128 pixels
+    TEST_ASSERT_EQUAL_HEX8(0x7F, data[clip.offsets[1]]);
+    TEST_ASSERT_EQUAL_HEX8(5, data[clip.offsets[1] + 1]);
+    TEST_ASSERT_EQUAL_HEX8(0x7F, data[clip.offsets[1] + 2]);
+    // every pixel changes: runs of 1
+    TEST_ASSERT_EQUAL(2 * MATRIX_WIDTH * MATRIX_HEIGHT, clip.offsets[4] - clip.offsets[3]);
+    // no change: two skip runs of 128
+    TEST_ASSERT_EQUAL(2, clip.offsets[11] - clip.offsets[10]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, data[clip.offsets[10]]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, data[clip.offsets[10] + 1]);
+    // 100 changed pixels and a skip run of 128 + 28
+    TEST_ASSERT_EQUAL(200 + 2, clip.offsets[12] - clip.offsets[11]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, data[clip.offsets[12] - 2]);
+    TEST_ASSERT_EQUAL_HEX8(0x80 + 27, data[clip.offsets[12] - 1]);
+}
+
+void test_clip_frame_by_frame_is_like_the_source(void) {
+    TestClip clip = makeClip();
+    const animation &anim = clip.anim;
+    std::vector<std::vector<uint8_t>> fromFirst = fromFirstFrame(anim);
+    for (int frame = 0; frame < anim.frameCount; frame++) {
+        std::vector<uint8_t> expected = expectedLeds(anim, clip.indices[frame]);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), fromFirst[frame].data(), frameSize);
+    }
+    assertFrameByFrame(anim);
+}
+
+void test_jumping_back_decodes_from_the_first_frame(void) {
+    TestClip clip = makeClip();
+    const animation &anim = clip.anim;
+    ledMap.fill(0);
+    AnimationPlayer player(anim);
+    player.draw(9 * anim.frameDuration);
+    for (int frame : {4, 2, 0, 11, 1, 12, 10}) {
+        player.draw(frame * anim.frameDuration);
+        std::vector<uint8_t> shown = leds();
+        std::vector<uint8_t> expected = expectedLeds(anim, clip.indices[frame]);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), shown.data(), frameSize);
+        // expectedLeds() has drawn over the animation
+        memcpy(matrix.getPixels(), shown.data(), frameSize);
+    }
+
+    // after invalidate() the frame which is shown already is decoded again from the first frame on
+    std::vector<uint8_t> expected = leds();
+    ledMap.fill(0xFFFF);
+    player.draw(10 * anim.frameDuration);
+    TEST_ASSERT_FALSE(leds() == expected);
+    player.invalidate();
+    player.draw(10 * anim.frameDuration);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), leds().data(), frameSize);
+}
+
+static void benchmark(const char *name, const animation &anim) {
+    const int rounds = 20000;
+    AnimationPlayer player(anim);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds * anim.frameCount; i++) {
+        player.draw(i * anim.frameDuration);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    int bytes = 0;
+    for (int frame = 0; frame < anim.frameCount; frame++) {
+        bytes += frameBytes(anim, frame);
+    }
+    char message[120];
+    snprintf(message, sizeof(message), "%s: %.2f us per frame, %.1f bytes per frame (%d as RGB565)", name,
+        seconds * 1e6 / rounds / anim.frameCount, (double)bytes / anim.frameCount, anim.width * anim.height * 2);
+    TEST_MESSAGE(message);
+}
+
+void test_benchmark(void) {
+    TestClip clip = makeClip();
+    benchmark("heart 8x8", heart);
+    benchmark("full change clip 32x8", clip.anim);
+}
+
+int main(int argc, char **argv) {
+    matrix.begin();
+    matrix.setBrightness(255);
+    ledMap.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_heart_frame_by_frame_is_like_from_the_first_frame);
+    RUN_TEST(test_heart_is_what_the_generator_makes);
+    RUN_TEST(test_clip_covers_all_runs);
+    RUN_TEST(test_clip_frame_by_frame_is_like_the_source);
+    RUN_TEST(test_jumping_back_decodes_from_the_first_frame);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
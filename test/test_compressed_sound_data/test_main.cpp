@@ -0,0 +1,328 @@
+// Host test and benchmark of G711SoundData and ImaAdpcmSoundData: run with pio test -e native -v
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <vector>
+#include "CompressedSoundData.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const int32_t RATE = 44100;
+
+// G.711 decoders of the reference implementation by Sun Microsystems (g711.c)
+static int16_t reference_ulaw(uint8_t u) {
+    u = ~u;
+    int t = ((u & 0x0F) << 3) + 0x84;
+    t <<= (u & 0x70) >> 4;
+    return (u & 0x80) ? (0x84 - t) : (t - 0x84);
+}
+
+static int16_t reference_alaw(uint8_t a) {
+    a ^= 0x55;
+    int t = (a & 0x0F) << 4;
+    int seg = (a & 0x70) >> 4;
+    switch (seg) {
+        case 0: t += 8; break;
+        case 1: t += 0x108; break;
+        default: t += 0x108; t <<= seg - 1;
+    }
+    return (a & 0x80) ? t : -t;
+}
+
+static const int16_t step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int index_table[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+// one channel of the IMA ADPCM reference algorithm (IMA Digital Audio Focus and Technical Working Groups, 1992)
+struct ImaChannel {
+    int predictor = 0;
+    int index = 0;
+
+    int16_t decode(int nibble) {
+        int step = step_table[index];
+        int diff = step >> 3;
+        if (nibble & 4) diff += step;
+        if (nibble & 2) diff += step >> 1;
+        if (nibble & 1) diff += step >> 2;
+        predictor += (nibble & 8) ? -diff : diff;
+        if (predictor > 32767) predictor = 32767;
+        if (predictor < -32768) predictor = -32768;
+        index += index_table[nibble];
+        if (index < 0) index = 0;
+        if (index > 88) index = 88;
+        return predictor;
+    }
+
+    // returns the nibble and decodes it, so that the encoder follows the decoder
+    int encode(int16_t sample) {
+        int diff = sample - predictor;
+        int nibble = 0;
+        if (diff < 0) {
+            nibble = 8;
+            diff = -diff;
+        }
+        int step = step_table[index];
+        if (diff >= step) { nibble |= 4; diff -= step; }
+        step >>= 1;
+        if (diff >= step) { nibble |= 2; diff -= step; }
+        step >>= 1;
+        if (diff >= step) { nibble |= 1; }
+        decode(nibble);
+        return nibble;
+    }
+};
+
+// WAV layout of a block: a header of 4 bytes per channel, then groups of 4 bytes (8 samples) per channel
+static int32_t samples_per_block(int32_t block_align, int channels) {
+    return 1 + (block_align - 4 * channels) / (4 * channels) * 8;
+}
+
+// encodes interleaved samples into blocks: the last block is only as long as it needs to be
+static std::vector<uint8_t> ima_encode(const std::vector<int16_t> &samples, int32_t block_align, int channels) {
+    std::vector<uint8_t> result;
+    int32_t frames = samples.size() / channels;
+    int32_t per_block = samples_per_block(block_align, channels);
+    ImaChannel state[2];
+    for (int32_t start = 0; start < frames; start += per_block) {
+        int32_t len = std::min(per_block, frames - start);
+        std::vector<uint8_t> block(4 * channels + (len - 1 + 7) / 8 * 4 * channels, 0);
+        for (int ch = 0; ch < channels; ch++) {
+            int16_t first = samples[start * channels + ch];
+            state[ch].predictor = first;
+            block[ch * 4] = first & 0xFF;
+            block[ch * 4 + 1] = (first >> 8) & 0xFF;
+            block[ch * 4 + 2] = state[ch].index;
+            for (int32_t s = 1; s < len; s++) {
+                int32_t k = s - 1;
+                uint8_t &byte = block[4 * channels + k / 8 * 4 * channels + ch * 4 + k % 8 / 2];
+                int nibble = state[ch].encode(samples[(start + s) * channels + ch]);
+                byte |= (k % 2) ? nibble << 4 : nibble;
+            }
+        }
+        result.insert(result.end(), block.begin(), block.end());
+    }
+    return result;
+}
+
+// decodes the blocks sample by sample into frames like get2ChannelData with ChannelInfo Both
+static std::vector<Frame> ima_decode(const std::vector<uint8_t> &data, int32_t block_align, int channels) {
+    std::vector<Frame> result;
+    int32_t per_block = samples_per_block(block_align, channels);
+    for (size_t start = 0; start < data.size(); start += block_align) {
+        const uint8_t *block = data.data() + start;
+        int32_t bytes = std::min((size_t) block_align, data.size() - start);
+        int32_t len = 1 + (bytes - 4 * channels) / (4 * channels) * 8;
+        len = std::min(len, per_block);
+        std::vector<Frame> frames(len);
+        for (int ch = 0; ch < channels; ch++) {
+            ImaChannel state;
+            state.predictor = (int16_t) (block[ch * 4] | (block[ch * 4 + 1] << 8));
+            state.index = block[ch * 4 + 2];
+            (ch == 0 ? frames[0].channel1 : frames[0].channel2) = state.predictor;
+            for (int32_t s = 1; s < len; s++) {
+                int32_t k = s - 1;
+                uint8_t byte = block[4 * channels + k / 8 * 4 * channels + ch * 4 + k % 8 / 2];
+                int16_t sample = state.decode((k % 2) ? byte >> 4 : byte & 0x0F);
+                (ch == 0 ? frames[s].channel1 : frames[s].channel2) = sample;
+            }
+        }
+        if (channels == 1) {
+            for (Frame &frame : frames) {
+                frame.channel2 = frame.channel1;
+            }
+        }
+        result.insert(result.end(), frames.begin(), frames.end());
+    }
+    return result;
+}
+
+// a sweep with a little noise: it uses most of the step sizes
+static std::vector<int16_t> test_signal(int32_t frames, int channels) {
+    std::vector<int16_t> result;
+    srand(3);
+    for (int32_t i = 0; i < frames; i++) {
+        for (int ch = 0; ch < channels; ch++) {
+            double phase = 2 * M_PI * (100.0 + 4000.0 * i / frames) * i / RATE + ch;
+            double amplitude = 30000.0 * i / frames;
+            result.push_back(amplitude * sin(phase) + rand() % 64 - 32);
+        }
+    }
+    return result;
+}
+
+void test_g711_tables_are_same_as_reference(void) {
+    uint8_t codes[256];
+    for (int j = 0; j < 256; j++) {
+        codes[j] = j;
+    }
+    Frame frames[256];
+    G711SoundData ulaw(codes, 256, ULaw);
+    G711SoundData alaw(codes, 256, ALaw);
+    TEST_ASSERT_EQUAL(256 * 4, ulaw.get2ChannelData(0, sizeof(frames), (uint8_t*) frames));
+    for (int j = 0; j < 256; j++) {
+        TEST_ASSERT_EQUAL_INT16(reference_ulaw(j), frames[j].channel1);
+        TEST_ASSERT_EQUAL_INT16(reference_ulaw(j), frames[j].channel2);
+    }
+    TEST_ASSERT_EQUAL(256 * 4, alaw.get2ChannelData(0, sizeof(frames), (uint8_t*) frames));
+    for (int j = 0; j < 256; j++) {
+        TEST_ASSERT_EQUAL_INT16(reference_alaw(j), frames[j].channel1);
+    }
+
+    // values of ITU-T G.711: the largest magnitude and the smallest step around 0
+    TEST_ASSERT_EQUAL_INT16(0, reference_ulaw(0xFF));
+    TEST_ASSERT_EQUAL_INT16(-32124, reference_ulaw(0x00));
+    TEST_ASSERT_EQUAL_INT16(32124, reference_ulaw(0x80));
+    TEST_ASSERT_EQUAL_INT16(8, reference_alaw(0xD5));
+    TEST_ASSERT_EQUAL_INT16(-32256, reference_alaw(0x2A));
+}
+
+void test_g711_channels_and_seek(void) {
+    uint8_t codes[1001];
+    for (int j = 0; j < 1001; j++) {
+        codes[j] = j * 7;
+    }
+    Frame frames[600];
+    G711SoundData stereo(codes, 1001, ULaw, 2);
+    TEST_ASSERT_EQUAL(500, stereo.count());
+    TEST_ASSERT_EQUAL(100 * 4, stereo.get2ChannelData(400 * 4, sizeof(frames), (uint8_t*) frames));
+    TEST_ASSERT_EQUAL_INT16(reference_ulaw(codes[800]), frames[0].channel1);
+    TEST_ASSERT_EQUAL_INT16(reference_ulaw(codes[999]), frames[99].channel2);
+    TEST_ASSERT_EQUAL(0, stereo.get2ChannelData(500 * 4, sizeof(frames), (uint8_t*) frames));
+
+    for (ChannelInfo info : {Left, Right}) {
+        G711SoundData mono(codes, 1001, ALaw, 1, false, info);
+        Frame frame;
+        TEST_ASSERT_EQUAL(1, mono.getData(1000, frame));
+        TEST_ASSERT_EQUAL_INT16(info == Left ? reference_alaw(codes[1000]) : 0, frame.channel1);
+        TEST_ASSERT_EQUAL_INT16(info == Right ? reference_alaw(codes[1000]) : 0, frame.channel2);
+        TEST_ASSERT_EQUAL(0, mono.getData(1001, frame));
+    }
+}
+
+static void check_ima_adpcm(int channels, int32_t block_align, int32_t signal_frames) {
+    std::vector<int16_t> samples = test_signal(signal_frames, channels);
+    std::vector<uint8_t> data = ima_encode(samples, block_align, channels);
+    std::vector<Frame> expected = ima_decode(data, block_align, channels);
+    // the last block ends with a whole group of 8 samples: it might be padded
+    int32_t frames = expected.size();
+    TEST_ASSERT_TRUE(frames >= signal_frames && frames < signal_frames + 8);
+
+    ImaAdpcmSoundData sound(data.data(), data.size(), block_align, channels);
+    TEST_ASSERT_EQUAL(frames, sound.count());
+
+    // all at once, then in blocks of the A2DP callback which start in the middle of the ADPCM blocks
+    std::vector<Frame> actual(frames + 10);
+    TEST_ASSERT_EQUAL(frames * 4, sound.get2ChannelData(0, actual.size() * 4, (uint8_t*) actual.data()));
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), actual.data(), frames * 4);
+    std::fill(actual.begin(), actual.end(), Frame(0x5555));
+    for (int32_t pos = 0; pos < frames; pos += 128) {
+        int32_t len = std::min(128, frames - pos);
+        TEST_ASSERT_EQUAL(len * 4, sound.get2ChannelData(pos * 4, 512, (uint8_t*) (actual.data() + pos)));
+    }
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), actual.data(), frames * 4);
+
+    // seeking backwards decodes the block again
+    Frame frame;
+    for (int32_t pos : {frames - 1, 0, frames / 2, 1}) {
+        TEST_ASSERT_EQUAL(1, sound.getData(pos, frame));
+        TEST_ASSERT_EQUAL_MEMORY(&expected[pos], &frame, 4);
+    }
+    TEST_ASSERT_EQUAL(0, sound.getData(frames, frame));
+
+    // the encoder and the decoder have to stay close to the signal
+    double error = 0, signal = 0;
+    for (int32_t i = 0; i < signal_frames; i++) {
+        double d = expected[i].channel1 - samples[i * channels];
+        error += d * d;
+        signal += (double) samples[i * channels] * samples[i * channels];
+    }
+    TEST_ASSERT_GREATER_THAN(20, (int) (10 * log10(signal / error)));
+}
+
+void test_ima_adpcm_is_same_as_reference(void) {
+    check_ima_adpcm(1, 1024, RATE / 2);
+    check_ima_adpcm(2, 1024, RATE / 2);
+    check_ima_adpcm(1, 256, 12345);
+    check_ima_adpcm(2, 512, 12345);
+}
+
+void test_ima_adpcm_mono_channel_info(void) {
+    std::vector<int16_t> samples = test_signal(3000, 1);
+    std::vector<uint8_t> data = ima_encode(samples, 256, 1);
+    std::vector<Frame> expected = ima_decode(data, 256, 1);
+    for (ChannelInfo info : {Left, Right}) {
+        ImaAdpcmSoundData sound(data.data(), data.size(), 256, 1, false, info);
+        Frame frame;
+        TEST_ASSERT_EQUAL(1, sound.getData(2999, frame));
+        TEST_ASSERT_EQUAL_INT16(info == Left ? expected[2999].channel1 : 0, frame.channel1);
+        TEST_ASSERT_EQUAL_INT16(info == Right ? expected[2999].channel1 : 0, frame.channel2);
+    }
+}
+
+// us to decode one second of audio in blocks of 512 bytes like the A2DP callback
+static double decode_time(SoundData &sound, int32_t frames) {
+    uint8_t block[512];
+    volatile uint8_t sink = 0;
+    const int rounds = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int32_t pos = 0; pos < frames * 4; pos += sizeof(block)) {
+            sound.get2ChannelData(pos, sizeof(block), block);
+            sink = sink + block[0];
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e6 / rounds / ((double) frames / RATE);
+}
+
+void test_benchmark(void) {
+    const int32_t frames = 10 * RATE;
+    std::vector<int16_t> mono = test_signal(frames, 1);
+    std::vector<int16_t> stereo = test_signal(frames, 2);
+    std::vector<uint8_t> ulaw(stereo.size());
+    for (size_t j = 0; j < stereo.size(); j++) {
+        ulaw[j] = stereo[j] >> 8; // the decode time does not depend on the codes
+    }
+    std::vector<uint8_t> adpcm_mono = ima_encode(mono, 1024, 1);
+    std::vector<uint8_t> adpcm_stereo = ima_encode(stereo, 1024, 2);
+
+    TwoChannelSoundData pcm((Frame*) stereo.data(), frames);
+    OneChannelSoundData pcm_mono(mono.data(), frames);
+    G711SoundData g711_mono(ulaw.data(), frames, ULaw, 1);
+    G711SoundData g711_stereo(ulaw.data(), frames * 2, ULaw, 2);
+    ImaAdpcmSoundData ima_mono(adpcm_mono.data(), adpcm_mono.size(), 1024, 1);
+    ImaAdpcmSoundData ima_stereo(adpcm_stereo.data(), adpcm_stereo.size(), 1024, 2);
+
+    struct { const char *name; SoundData *sound; int32_t bytes_per_second; } runs[] = {
+        { "PCM stereo", &pcm, RATE * 4 },
+        { "PCM mono", &pcm_mono, RATE * 2 },
+        { "G.711 mono", &g711_mono, RATE },
+        { "G.711 stereo", &g711_stereo, RATE * 2 },
+        { "IMA-ADPCM mono", &ima_mono, RATE / 2 },
+        { "IMA-ADPCM stereo", &ima_stereo, RATE },
+    };
+    for (auto &run : runs) {
+        char message[160];
+        snprintf(message, sizeof(message), "%s: %.0f us per second of audio, %d bytes per second",
+            run.name, decode_time(*run.sound, frames), run.bytes_per_second);
+        TEST_MESSAGE(message);
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_g711_tables_are_same_as_reference);
+    RUN_TEST(test_g711_channels_and_seek);
+    RUN_TEST(test_ima_adpcm_is_same_as_reference);
+    RUN_TEST(test_ima_adpcm_mono_channel_info);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
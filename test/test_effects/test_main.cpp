@@ -0,0 +1,114 @@
+// Host test and benchmark of the effects against matrix.rainbow(): run with pio test -e native -v
+#include <unity.h>
+#include <chrono>
+#include <stdlib.h>
+#include <Arduino.h>
+#include "images.h"
+#include "ledmap.h"
+#include "effects.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const size_t frameSize = MATRIX_WIDTH * MATRIX_HEIGHT * 3;
+
+static Adafruit_NeoMatrix reference(MATRIX_WIDTH, MATRIX_HEIGHT, PIN, MATRIX_LAYOUT, MATRIX_PIXEL_TYPE);
+
+// a whole frame of the effect
+static void drawFrame(int number, unsigned long now) {
+    effectRunner.setEffect(number);
+    effectRunner.draw(now);
+}
+
+void test_every_effect_draws_every_pixel(void) {
+    for (int number = 0; number < numberOfEffects; number++) {
+        for (unsigned long now = 0; now < 10000; now += 997) {
+            // a color which none of the effects uses
+            memset(matrix.getPixels(), 0xAB, frameSize);
+            drawFrame(number, now);
+            for (size_t i = 0; i < frameSize; i += 3) {
+                const uint8_t *p = matrix.getPixels() + i;
+                TEST_ASSERT_FALSE_MESSAGE(p[0] == 0xAB && p[1] == 0xAB && p[2] == 0xAB, effects[number].name);
+            }
+        }
+    }
+}
+
+// the 256 step hue table and the RGB565 colors of the matrix against the 1530 step hue and 8 bit gamma of the
+// library: the quantization is amplified by the gamma where the curve is steep
+void test_rainbow_is_close_to_matrix_rainbow(void) {
+    int maxDifference = 0;
+    long sumDifference = 0;
+    long count = 0;
+    for (unsigned long now = 0; now < 2560; now += 10) {
+        drawFrame(0, now);
+        reference.rainbow((now / RAINBOW_STEP_TIME) * 256);
+        for (size_t i = 0; i < frameSize; i++, count++) {
+            int difference = abs(matrix.getPixels()[i] - reference.getPixels()[i]);
+            maxDifference = max(maxDifference, difference);
+            sumDifference += difference;
+        }
+    }
+    char message[80];
+    snprintf(message, sizeof(message), "difference per channel: max %d, mean %.2f", maxDifference,
+        (double)sumDifference / count);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(maxDifference <= 48);
+    TEST_ASSERT_TRUE(sumDifference < 3 * count);
+}
+
+void test_fire_is_hotter_at_the_bottom(void) {
+    memset(fireHeat, 0, sizeof(fireHeat));
+    long rowHeat[MATRIX_HEIGHT] = { 0 };
+    for (unsigned long now = 0; now < 30000; now += 33) {
+        drawFrame(2, now);
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+            for (int y = 0; y < MATRIX_HEIGHT; y++) {
+                rowHeat[y] += fireHeat[x][y];
+            }
+        }
+    }
+    // the sparks are in the bottom row and the heat cools down on the way up
+    for (int y = 0; y < MATRIX_HEIGHT - 1; y++) {
+        TEST_ASSERT_TRUE(rowHeat[y] < rowHeat[y + 1]);
+    }
+    TEST_ASSERT_TRUE(rowHeat[0] > 0);
+}
+
+void test_benchmark(void) {
+    const int frames = 20000;
+    char message[120];
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        reference.rainbow(i * 256);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    snprintf(message, sizeof(message), "matrix.rainbow: %.2f us per frame", seconds * 1e6 / frames);
+    TEST_MESSAGE(message);
+
+    for (int number = 0; number < numberOfEffects; number++) {
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            drawFrame(number, i * 33);
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        snprintf(message, sizeof(message), "%s: %.2f us per frame, budget %lu us", effects[number].name,
+            seconds * 1e6 / frames, effects[number].budget);
+        TEST_MESSAGE(message);
+    }
+}
+
+int main(int argc, char **argv) {
+    matrix.begin();
+    matrix.setBrightness(255);
+    reference.setBrightness(255);
+    ledMap.begin();
+    effectRunner.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_every_effect_draws_every_pixel);
+    RUN_TEST(test_rainbow_is_close_to_matrix_rainbow);
+    RUN_TEST(test_fire_is_hotter_at_the_bottom);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+// Host test of the frame pipeline of FrameBuffer: present() and the sender task as two threads. Run with
+// pio test -e native
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <Arduino.h>
+#include "images.h"
+#include "scheduler.h"
+#include "ledoutput.h"
+#include "framebuffer.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint16_t stripSize = 64; // pixels
+
+// frame number n in every 4 bytes of the pixels
+static void drawFrame(Adafruit_NeoPixel &strip, uint32_t n) {
+    uint8_t *pixels = strip.getPixels();
+    for (size_t i = 0; i < stripSize * 3; i++) {
+        pixels[i] = (uint8_t)(n >> (8 * (i % 4)));
+    }
+}
+
+static uint32_t numberOf(const uint8_t *pixels) {
+    return pixels[0] | ((uint32_t)pixels[1] << 8) | ((uint32_t)pixels[2] << 16) | ((uint32_t)pixels[3] << 24);
+}
+
+static bool isFrame(const uint8_t *pixels, size_t size, uint32_t n) {
+    for (size_t i = 0; i < size; i++) {
+        if (pixels[i] != (uint8_t)(n >> (8 * (i % 4)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// checks the frames which the sender task shows: only the sender task writes the fields. The pixels are checked again
+// at the end of show(), as an output still reads them while it sends.
+class CheckingOutput : public LedOutput {
+  public:
+    void show(const uint8_t *pixels, size_t size) {
+      entered++;
+      uint32_t n = numberOf(pixels);
+      bool whole = isFrame(pixels, size, n);
+      if (frames > 0 && n <= last) {
+        outOfOrder++;
+      }
+      last = n;
+      frames++;
+      while (hold) {
+        std::this_thread::yield();
+      }
+      if (slow) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+      if (!whole || !isFrame(pixels, size, n)) {
+        torn++;
+      }
+    }
+
+    std::atomic<bool> hold = { false }; // show() waits until it is cleared
+    std::atomic<uint32_t> entered = { 0 };
+    bool slow = false;
+    uint32_t frames = 0;
+    uint32_t last = 0;
+    uint32_t torn = 0;
+    uint32_t outOfOrder = 0;
+};
+
+// like in the firmware the frame buffers live as long as their sender tasks, which keep waiting for a notification
+static Adafruit_NeoPixel busyStrip(stripSize), threadStrip(stripSize);
+static CheckingOutput busyOutput, threadOutput;
+static FrameBuffer busyFrameBuffer(busyStrip), threadFrameBuffer(threadStrip);
+
+// shows() reads the count under the lock of the sender task, so the fields of the output are up to date after it
+static void waitForShows(FrameBuffer &frameBuffer, uint32_t shows) {
+    while (frameBuffer.shows() < shows) {
+        std::this_thread::yield();
+    }
+}
+
+// the sender task is busy with frame 0: of 1, 2 and 3 only the latest one is shown, the others are dropped
+void test_latest_frame_wins_while_the_sender_is_busy(void) {
+    Adafruit_NeoPixel &strip = busyStrip;
+    CheckingOutput &output = busyOutput;
+    FrameBuffer &frameBuffer = busyFrameBuffer;
+    frameBuffer.begin(output);
+
+    output.hold = true;
+    drawFrame(strip, 0);
+    TEST_ASSERT_TRUE(frameBuffer.present());
+    while (output.entered == 0) {
+        std::this_thread::yield();
+    }
+    for (uint32_t n = 1; n <= 3; n++) {
+        drawFrame(strip, n);
+        TEST_ASSERT_TRUE(frameBuffer.present());
+    }
+    TEST_ASSERT_EQUAL(2, frameBuffer.droppedFrames());
+    TEST_ASSERT_EQUAL(0, frameBuffer.shows());
+
+    output.hold = false;
+    waitForShows(frameBuffer, 2);
+    TEST_ASSERT_EQUAL(2, output.frames);
+    TEST_ASSERT_EQUAL(3, output.last);
+    TEST_ASSERT_EQUAL(0, output.torn);
+    TEST_ASSERT_EQUAL(2, frameBuffer.droppedFrames());
+
+    // an unchanged frame is not handed over
+    TEST_ASSERT_FALSE(frameBuffer.present());
+    TEST_ASSERT_EQUAL(1, frameBuffer.skippedShows());
+}
+
+// present() on one thread as fast as it can, a slow output on the sender task: every frame is either shown or
+// counted as dropped, the shown ones are whole and in order and the last one is always shown
+void test_present_and_sender_threads(void) {
+    const uint32_t total = 20000;
+    Adafruit_NeoPixel &strip = threadStrip;
+    CheckingOutput &output = threadOutput;
+    FrameBuffer &frameBuffer = threadFrameBuffer;
+    output.slow = true;
+    frameBuffer.begin(output);
+
+    std::thread presenter([&]() {
+        for (uint32_t n = 0; n < total; n++) {
+            drawFrame(strip, n);
+            frameBuffer.present();
+            // what report() reads on core 0 while the sender task shows
+            frameBuffer.averageShowTime();
+        }
+    });
+    presenter.join();
+
+    while (frameBuffer.shows() + frameBuffer.droppedFrames() < total) {
+        std::this_thread::yield();
+    }
+    TEST_ASSERT_EQUAL(total, frameBuffer.shows() + frameBuffer.droppedFrames());
+    TEST_ASSERT_EQUAL(frameBuffer.shows(), output.frames);
+    TEST_ASSERT_EQUAL(0, output.torn);
+    TEST_ASSERT_EQUAL(0, output.outOfOrder);
+    TEST_ASSERT_EQUAL(total - 1, output.last);
+    TEST_ASSERT_TRUE(frameBuffer.droppedFrames() > 0);
+    TEST_ASSERT_EQUAL(0, frameBuffer.skippedShows());
+}
+
+int main(int argc, char **argv) {
+    Serial.isCaptured = true;
+    UNITY_BEGIN();
+    RUN_TEST(test_latest_frame_wins_while_the_sender_is_busy);
+    RUN_TEST(test_present_and_sender_threads);
+    return UNITY_END();
+}
@@ -0,0 +1,110 @@
+// Host test of FrameRingBuffer: run with pio test -e native
+#include <unity.h>
+#include <thread>
+#include <vector>
+#include "FrameRingBuffer.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// frame number n as two 16 bit channels
+static Frame frame_of(uint32_t n) {
+    return Frame((int16_t)(n & 0xFFFF), (int16_t)(n >> 16));
+}
+
+static uint32_t number_of(const Frame &frame) {
+    return (uint16_t)frame.channel1 | ((uint32_t)(uint16_t)frame.channel2 << 16);
+}
+
+void test_capacity_is_rounded_up_to_a_power_of_2(void) {
+    FrameRingBuffer buffer(1000);
+    TEST_ASSERT_EQUAL(1024, buffer.size());
+    TEST_ASSERT_EQUAL(0, buffer.available());
+    TEST_ASSERT_EQUAL(1024, buffer.available_for_write());
+}
+
+void test_write_stops_when_full_and_wraps_around(void) {
+    FrameRingBuffer buffer(8);
+    Frame in[12], out[12];
+    for (int j = 0; j < 12; j++) {
+        in[j] = frame_of(j);
+    }
+    TEST_ASSERT_EQUAL(8, buffer.write(in, 12));
+    TEST_ASSERT_EQUAL(0, buffer.write(in, 1));
+    TEST_ASSERT_EQUAL(5, buffer.read(out, 5));
+    TEST_ASSERT_EQUAL(4, number_of(out[4]));
+
+    // the next write wraps around the end of the memory
+    TEST_ASSERT_EQUAL(4, buffer.write(in + 8, 4));
+    TEST_ASSERT_EQUAL(7, buffer.read(out, 12));
+    for (int j = 0; j < 7; j++) {
+        TEST_ASSERT_EQUAL(5 + j, number_of(out[j]));
+    }
+    TEST_ASSERT_EQUAL(0, buffer.available());
+}
+
+void test_clear_discards_the_readable_frames(void) {
+    FrameRingBuffer buffer(16);
+    Frame in[10];
+    buffer.write(in, 10);
+    buffer.clear();
+    TEST_ASSERT_EQUAL(0, buffer.available());
+    TEST_ASSERT_EQUAL(16, buffer.available_for_write());
+}
+
+// a producer and a consumer thread with different chunk sizes: every frame arrives once and in order
+void test_producer_and_consumer_threads(void) {
+    const uint32_t total = 2000000;
+    FrameRingBuffer buffer(512);
+    uint32_t errors = 0, received = 0;
+
+    std::thread producer([&]() {
+        Frame chunk[97];
+        uint32_t next = 0;
+        while (next < total) {
+            int32_t len = std::min<uint32_t>(1 + next % 97, total - next);
+            for (int j = 0; j < len; j++) {
+                chunk[j] = frame_of(next + j);
+            }
+            int32_t written = 0;
+            while (written < len) {
+                written += buffer.write(chunk + written, len - written);
+                if (written < len) {
+                    std::this_thread::yield();
+                }
+            }
+            next += len;
+        }
+    });
+
+    std::thread consumer([&]() {
+        Frame chunk[128];
+        while (received < total) {
+            int32_t len = buffer.read(chunk, 1 + received % 128);
+            for (int j = 0; j < len; j++) {
+                if (number_of(chunk[j]) != received + j) {
+                    errors++;
+                }
+            }
+            received += len;
+            if (len == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    TEST_ASSERT_EQUAL(total, received);
+    TEST_ASSERT_EQUAL(0, errors);
+    TEST_ASSERT_EQUAL(0, buffer.available());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_capacity_is_rounded_up_to_a_power_of_2);
+    RUN_TEST(test_write_stops_when_full_and_wraps_around);
+    RUN_TEST(test_clear_discards_the_readable_frames);
+    RUN_TEST(test_producer_and_consumer_threads);
+    return UNITY_END();
+}
@@ -0,0 +1,272 @@
+// synthwave in the format of images.h before drawImage(): one struct pixel per LED, column by column, with the
+// coordinates and the color bytes which were passed to matrix.Color() in this order. Only kept for test_led_map.
+#pragma once
+
+#include <stdint.h>
+
+struct legacyPixel {
+  int x;
+  int y;
+  uint8_t green;
+  uint8_t red;
+  uint8_t blue;
+};
+
+const legacyPixel legacySynthwave[256] = {
+{0, 0, 0, 0, 0},
+{0, 1, 0, 0, 0},
+{0, 2, 0, 1, 0},
+{0, 3, 0, 0, 0},
+{0, 4, 0, 0, 1},
+{0, 5, 0, 0, 0},
+{0, 6, 24, 24, 22},
+{0, 7, 0, 0, 1},
+{1, 0, 0, 0, 0},
+{1, 1, 23, 23, 23},
+{1, 2, 0, 1, 0},
+{1, 3, 0, 0, 0},
+{1, 4, 0, 0, 1},
+{1, 5, 0, 0, 0},
+{1, 6, 0, 0, 0},
+{1, 7, 0, 0, 1},
+{2, 0, 0, 0, 0},
+{2, 1, 0, 1, 0},
+{2, 2, 0, 0, 0},
+{2, 3, 5, 9, 7},
+{2, 4, 2, 2, 2},
+{2, 5, 0, 0, 0},
+{2, 6, 9, 9, 9},
+{2, 7, 0, 0, 0},
+{3, 0, 0, 0, 0},
+{3, 1, 23, 25, 24},
+{3, 2, 0, 0, 0},
+{3, 3, 9, 13, 11},
+{3, 4, 4, 4, 4},
+{3, 5, 0, 0, 0},
+{3, 6, 15, 15, 15},
+{3, 7, 0, 0, 0},
+{4, 0, 18, 18, 18},
+{4, 1, 0, 0, 0},
+{4, 2, 0, 1, 0},
+{4, 3, 0, 1, 0},
+{4, 4, 0, 0, 0},
+{4, 5, 0, 0, 0},
+{4, 6, 2, 2, 2},
+{4, 7, 21, 21, 21},
+{5, 0, 0, 0, 0},
+{5, 1, 0, 0, 0},
+{5, 2, 0, 2, 1},
+{5, 3, 0, 1, 0},
+{5, 4, 0, 0, 0},
+{5, 5, 0, 0, 0},
+{5, 6, 2, 2, 2},
+{5, 7, 15, 15, 15},
+{6, 0, 0, 1, 0},
+{6, 1, 1, 1, 0},
+{6, 2, 1, 1, 1},
+{6, 3, 23, 25, 24},
+{6, 4, 0, 0, 0},
+{6, 5, 0, 0, 0},
+{6, 6, 24, 26, 25},
+{6, 7, 7, 7, 7},
+{7, 0, 23, 25, 24},
+{7, 1, 1, 1, 0},
+{7, 2, 1, 1, 1},
+{7, 3, 0, 1, 0},
+{7, 4, 1, 1, 1},
+{7, 5, 2, 2, 2},
+{7, 6, 2, 4, 3},
+{7, 7, 2, 2, 2},
+{8, 0, 1, 1, 1},
+{8, 1, 2, 0, 2},
+{8, 2, 1, 3, 0},
+{8, 3, 0, 17, 0},
+{8, 4, 0, 37, 0},
+{8, 5, 0, 61, 0},
+{8, 6, 0, 34, 0},
+{8, 7, 0, 55, 10},
+{9, 0, 0, 0, 0},
+{9, 1, 2, 0, 2},
+{9, 2, 5, 7, 4},
+{9, 3, 26, 49, 16},
+{9, 4, 35, 83, 23},
+{9, 5, 26, 110, 36},
+{9, 6, 14, 62, 26},
+{9, 7, 28, 108, 63},
+{10, 0, 1, 13, 0},
+{10, 1, 31, 112, 0},
+{10, 2, 72, 181, 0},
+{10, 3, 48, 164, 0},
+{10, 4, 29, 165, 0},
+{10, 5, 0, 165, 22},
+{10, 6, 0, 92, 24},
+{10, 7, 1, 150, 75},
+{11, 0, 57, 69, 31},
+{11, 1, 133, 214, 52},
+{11, 2, 90, 199, 8},
+{11, 3, 48, 164, 0},
+{11, 4, 29, 165, 0},
+{11, 5, 0, 164, 21},
+{11, 6, 0, 92, 24},
+{11, 7, 18, 167, 92},
+{12, 0, 199, 245, 1},
+{12, 1, 133, 255, 0},
+{12, 2, 89, 205, 0},
+{12, 3, 49, 163, 0},
+{12, 4, 29, 163, 2},
+{12, 5, 0, 164, 19},
+{12, 6, 1, 89, 23},
+{12, 7, 97, 109, 149},
+{13, 0, 207, 253, 9},
+{13, 1, 133, 255, 0},
+{13, 2, 89, 205, 0},
+{13, 3, 49, 163, 0},
+{13, 4, 29, 163, 2},
+{13, 5, 0, 164, 19},
+{13, 6, 3, 91, 25},
+{13, 7, 90, 102, 142},
+{14, 0, 207, 254, 4},
+{14, 1, 134, 255, 0},
+{14, 2, 91, 204, 1},
+{14, 3, 53, 147, 15},
+{14, 4, 50, 108, 47},
+{14, 5, 63, 63, 89},
+{14, 6, 120, 39, 151},
+{14, 7, 119, 32, 150},
+{15, 0, 207, 254, 4},
+{15, 1, 134, 255, 0},
+{15, 2, 90, 203, 0},
+{15, 3, 66, 161, 28},
+{15, 4, 93, 151, 91},
+{15, 5, 108, 109, 134},
+{15, 6, 126, 45, 157},
+{15, 7, 131, 44, 162},
+{16, 0, 207, 254, 4},
+{16, 1, 133, 255, 0},
+{16, 2, 121, 192, 55},
+{16, 3, 93, 55, 104},
+{16, 4, 92, 17, 115},
+{16, 5, 125, 49, 150},
+{16, 6, 134, 43, 166},
+{16, 7, 130, 39, 160},
+{17, 0, 207, 254, 4},
+{17, 1, 133, 255, 0},
+{17, 2, 108, 179, 41},
+{17, 3, 108, 70, 120},
+{17, 4, 101, 26, 124},
+{17, 5, 92, 16, 117},
+{17, 6, 128, 37, 159},
+{17, 7, 128, 37, 158},
+{18, 0, 207, 254, 4},
+{18, 1, 133, 255, 0},
+{18, 2, 89, 205, 0},
+{18, 3, 48, 163, 1},
+{18, 4, 80, 129, 83},
+{18, 5, 76, 72, 105},
+{18, 6, 117, 37, 156},
+{18, 7, 91, 20, 111},
+{19, 0, 207, 254, 4},
+{19, 1, 133, 255, 0},
+{19, 2, 89, 205, 0},
+{19, 3, 48, 163, 1},
+{19, 4, 51, 100, 54},
+{19, 5, 68, 64, 97},
+{19, 6, 111, 31, 150},
+{19, 7, 94, 23, 114},
+{20, 0, 206, 249, 25},
+{20, 1, 133, 255, 0},
+{20, 2, 89, 205, 0},
+{20, 3, 48, 163, 1},
+{20, 4, 28, 165, 2},
+{20, 5, 0, 164, 21},
+{20, 6, 0, 90, 23},
+{20, 7, 82, 129, 148},
+{21, 0, 161, 204, 0},
+{21, 1, 133, 255, 0},
+{21, 2, 89, 205, 0},
+{21, 3, 48, 163, 1},
+{21, 4, 28, 165, 2},
+{21, 5, 0, 164, 21},
+{21, 6, 0, 90, 23},
+{21, 7, 47, 94, 114},
+{22, 0, 13, 14, 5},
+{22, 1, 110, 165, 55},
+{22, 2, 94, 182, 30},
+{22, 3, 48, 164, 0},
+{22, 4, 28, 165, 2},
+{22, 5, 0, 164, 21},
+{22, 6, 0, 92, 23},
+{22, 7, 0, 154, 70},
+{23, 0, 0, 1, 0},
+{23, 1, 1, 57, 0},
+{23, 2, 37, 125, 0},
+{23, 3, 48, 164, 0},
+{23, 4, 28, 165, 2},
+{23, 5, 0, 162, 20},
+{23, 6, 0, 92, 23},
+{23, 7, 0, 154, 70},
+{24, 0, 1, 1, 1},
+{24, 1, 0, 0, 0},
+{24, 2, 0, 0, 0},
+{24, 3, 1, 3, 2},
+{24, 4, 17, 38, 12},
+{24, 5, 17, 70, 23},
+{24, 6, 11, 40, 19},
+{24, 7, 18, 66, 40},
+{25, 0, 0, 0, 0},
+{25, 1, 0, 0, 0},
+{25, 2, 0, 0, 0},
+{25, 3, 0, 1, 0},
+{25, 4, 0, 21, 0},
+{25, 5, 0, 40, 0},
+{25, 6, 0, 22, 1},
+{25, 7, 0, 40, 14},
+{26, 0, 0, 0, 0},
+{26, 1, 0, 0, 0},
+{26, 2, 24, 26, 25},
+{26, 3, 0, 0, 0},
+{26, 4, 14, 14, 14},
+{26, 5, 2, 2, 2},
+{26, 6, 1, 1, 0},
+{26, 7, 18, 21, 17},
+{27, 0, 0, 0, 0},
+{27, 1, 0, 0, 0},
+{27, 2, 0, 1, 0},
+{27, 3, 0, 0, 0},
+{27, 4, 0, 0, 0},
+{27, 5, 12, 12, 12},
+{27, 6, 1, 1, 0},
+{27, 7, 0, 3, 0},
+{28, 0, 0, 0, 0},
+{28, 1, 24, 24, 24},
+{28, 2, 0, 0, 0},
+{28, 3, 0, 0, 0},
+{28, 4, 0, 0, 1},
+{28, 5, 12, 12, 12},
+{28, 6, 0, 0, 0},
+{28, 7, 6, 6, 6},
+{29, 0, 0, 0, 0},
+{29, 1, 0, 0, 0},
+{29, 2, 0, 0, 0},
+{29, 3, 0, 0, 0},
+{29, 4, 17, 18, 19},
+{29, 5, 0, 0, 0},
+{29, 6, 0, 0, 0},
+{29, 7, 0, 0, 0},
+{30, 0, 0, 0, 0},
+{30, 1, 0, 0, 0},
+{30, 2, 1, 1, 1},
+{30, 3, 0, 0, 0},
+{30, 4, 6, 6, 6},
+{30, 5, 0, 0, 0},
+{30, 6, 3, 16, 9},
+{30, 7, 0, 0, 0},
+{31, 0, 0, 0, 0},
+{31, 1, 0, 0, 0},
+{31, 2, 0, 0, 0},
+{31, 3, 0, 0, 0},
+{31, 4, 0, 0, 0},
+{31, 5, 0, 0, 0},
+{31, 6, 0, 9, 2},
+{31, 7, 0, 0, 0} };
+
@@ -0,0 +1,187 @@
+// Host test of LedMap against Adafruit_NeoMatrix and benchmark of the cost per pixel: run with pio test -e native -v.
+// The matrix is the stand-in of test/native, which follows the layout and color rules of the library. The images are
+// also compared with their format before drawImage(), see legacy_synthwave.h.
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include <Arduino.h>
+#include "images.h"
+#include "ledmap.h"
+#include "legacy_synthwave.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const size_t frameSize = MATRIX_WIDTH * MATRIX_HEIGHT * 3;
+
+// the same xorshift as the effects, for colors which cover all bits
+static uint32_t randomState = 1;
+
+static uint16_t randomColor() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+static std::vector<uint8_t> pixelsOf(Adafruit_NeoMatrix &m) {
+    return std::vector<uint8_t>(m.getPixels(), m.getPixels() + frameSize);
+}
+
+// draws the frame with the library into reference and with ledMap into matrix
+static Adafruit_NeoMatrix reference(MATRIX_WIDTH, MATRIX_HEIGHT, PIN, MATRIX_LAYOUT, MATRIX_PIXEL_TYPE);
+
+static void setBrightness(uint8_t brightness) {
+    matrix.setBrightness(brightness);
+    reference.setBrightness(brightness);
+}
+
+void test_table_follows_the_layout_of_the_library(void) {
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+            TEST_ASSERT_EQUAL(matrix.ledIndex(x, y), ledMapTable::map[y * MATRIX_WIDTH + x]);
+            TEST_ASSERT_EQUAL(matrix.ledIndex(x, y), ledIndex(x, y));
+        }
+    }
+}
+
+void test_pixel_is_like_draw_pixel(void) {
+    for (int brightness : {255, 254, 128, 20, 1, 0}) {
+        setBrightness(brightness);
+        for (int i = 0; i < 20000; i++) {
+            uint16_t color = randomColor();
+            int16_t x = (randomState >> 16) % (MATRIX_WIDTH + 4) - 2;
+            int16_t y = (randomState >> 24) % (MATRIX_HEIGHT + 4) - 2;
+            reference.drawPixel(x, y, color);
+            ledMap.pixel(x, y, color);
+        }
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize);
+    }
+    // every RGB565 value
+    setBrightness(255);
+    for (uint32_t color = 0; color < 0x10000; color++) {
+        reference.drawPixel(3, 5, color);
+        ledMap.pixel(3, 5, color);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize);
+    }
+}
+
+void test_fill_column_and_bitmap_are_like_the_library(void) {
+    setBrightness(50);
+    reference.fillScreen(0x1234);
+    ledMap.fill(0x1234);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize);
+
+    for (int x = -1; x <= MATRIX_WIDTH; x++) {
+        uint8_t bits = x * 37;
+        for (int y = 0; y < MATRIX_HEIGHT; y++) {
+            if (bits & (1 << y)) {
+                reference.drawPixel(x, y, 0xF81F);
+            }
+        }
+        ledMap.column(x, bits, 0xF81F);
+    }
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize);
+
+    reference.drawRGBBitmap(-3, 1, synthwave.pixels, synthwave.width, synthwave.height);
+    ledMap.bitmap(-3, 1, synthwave.pixels, synthwave.width, synthwave.height);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize);
+}
+
+// synthwaveScreen() before drawImage()
+static void drawLegacySynthwave(Adafruit_NeoMatrix &m) {
+    int pixelNum = 0;
+    for (int x = 0; x < 32 && pixelNum < 256; x++) {
+        for (int y = 0; y < 8; y++) {
+            const legacyPixel &p = legacySynthwave[pixelNum];
+            m.writePixel(p.x, p.y, m.Color(p.green, p.red, p.blue));
+            pixelNum++;
+        }
+    }
+}
+
+void test_image_is_like_the_legacy_format(void) {
+    setBrightness(20);
+    reference.fillScreen(0);
+    drawLegacySynthwave(reference);
+    ledMap.fill(0xFFFF);
+    drawImage(synthwave);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize);
+
+    // the flash of the pixels: 12 bytes per LED before, 2 now
+    TEST_ASSERT_EQUAL(3072, sizeof(legacySynthwave));
+    TEST_ASSERT_EQUAL(512, sizeof(synthwavePixels));
+    char message[120];
+    snprintf(message, sizeof(message), "synthwave: %zu bytes as struct pixel, %zu bytes of RGB565 + %zu bytes of image",
+        sizeof(legacySynthwave), sizeof(synthwavePixels), sizeof(image));
+    TEST_MESSAGE(message);
+}
+
+// ns per pixel of a whole frame, drawn frames times
+template <typename Draw> static double nsPerPixel(int frames, Draw draw) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        draw(i);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / frames / (MATRIX_WIDTH * MATRIX_HEIGHT);
+}
+
+void test_benchmark(void) {
+    const int frames = 20000;
+    setBrightness(20);
+    double drawPixel = nsPerPixel(frames, [](int i) {
+        for (int y = 0; y < MATRIX_HEIGHT; y++) {
+            for (int x = 0; x < MATRIX_WIDTH; x++) {
+                reference.drawPixel(x, y, i + x);
+            }
+        }
+    });
+    double pixel = nsPerPixel(frames, [](int i) {
+        for (int y = 0; y < MATRIX_HEIGHT; y++) {
+            for (int x = 0; x < MATRIX_WIDTH; x++) {
+                ledMap.pixel(x, y, i + x);
+            }
+        }
+    });
+    double column = nsPerPixel(frames, [](int i) {
+        for (int x = 0; x < MATRIX_WIDTH; x++) {
+            ledMap.column(x, 0xFF, i + x);
+        }
+    });
+    double drawRGBBitmap = nsPerPixel(frames, [](int i) {
+        reference.drawRGBBitmap(i & 1, 0, synthwave.pixels, synthwave.width, synthwave.height);
+    });
+    double bitmap = nsPerPixel(frames, [](int i) {
+        ledMap.bitmap(i & 1, 0, synthwave.pixels, synthwave.width, synthwave.height);
+    });
+    double legacyImage = nsPerPixel(frames, [](int i) { drawLegacySynthwave(matrix); });
+    double image = nsPerPixel(frames, [](int i) { drawImage(synthwave); });
+    double fillScreen = nsPerPixel(frames, [](int i) { reference.fillScreen(i); });
+    double fill = nsPerPixel(frames, [](int i) { ledMap.fill(i); });
+
+    char message[120];
+    snprintf(message, sizeof(message), "ns per pixel: drawPixel %.2f, ledMap.pixel %.2f, ledMap.column %.2f",
+        drawPixel, pixel, column);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "ns per pixel: drawRGBBitmap %.2f, ledMap.bitmap %.2f", drawRGBBitmap, bitmap);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "ns per pixel: fillScreen %.2f, ledMap.fill %.2f", fillScreen, fill);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "ns per pixel of synthwave: struct pixel %.2f, drawImage %.2f = %.2f us per frame",
+        legacyImage, image, image * MATRIX_WIDTH * MATRIX_HEIGHT / 1000);
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv) {
+    matrix.begin();
+    ledMap.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_table_follows_the_layout_of_the_library);
+    RUN_TEST(test_pixel_is_like_draw_pixel);
+    RUN_TEST(test_fill_column_and_bitmap_are_like_the_library);
+    RUN_TEST(test_image_is_like_the_legacy_format);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
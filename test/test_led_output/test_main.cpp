@@ -0,0 +1,136 @@
+// Host test of the LED outputs and benchmark of Ws2812Encoder against an encoder which works bit by bit.
+// Run with pio test -e native -v
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include <Arduino.h>
+#include "images.h"
+#include "ledoutput.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const size_t frameSize = MATRIX_WIDTH * MATRIX_HEIGHT * 3;
+
+// the straightforward encoder: one item per bit through the fields of rmt_item32_t
+static void encodeBits(const uint8_t *pixels, size_t size, rmt_item32_t *items, uint16_t zeroHigh = 16,
+                       uint16_t zeroLow = 34, uint16_t oneHigh = 32, uint16_t oneLow = 18) {
+    for (size_t i = 0; i < size; i++) {
+        for (int bit = 7; bit >= 0; bit--, items++) {
+            bool one = pixels[i] & (1 << bit);
+            items->level0 = 1;
+            items->duration0 = one ? oneHigh : zeroHigh;
+            items->level1 = 0;
+            items->duration1 = one ? oneLow : zeroLow;
+        }
+    }
+}
+
+static std::vector<uint8_t> randomPixels(size_t size) {
+    std::vector<uint8_t> pixels(size);
+    for (uint8_t &p : pixels) {
+        p = random(256);
+    }
+    return pixels;
+}
+
+void test_encoder_is_like_bit_by_bit(void) {
+    std::vector<uint8_t> pixels(256);
+    for (int i = 0; i < 256; i++) {
+        pixels[i] = i;
+    }
+    std::vector<uint32_t> items(256 * 8);
+    std::vector<rmt_item32_t> expected(256 * 8);
+    Ws2812Encoder encoder;
+    TEST_ASSERT_EQUAL(256 * 8, encoder.encode(pixels.data(), pixels.size(), items.data()));
+    encodeBits(pixels.data(), pixels.size(), expected.data());
+    for (size_t i = 0; i < items.size(); i++) {
+        TEST_ASSERT_EQUAL_HEX32(expected[i].val, items[i]);
+    }
+
+    // other timings
+    Ws2812Encoder slow(10, 40, 30, 20);
+    pixels = randomPixels(frameSize);
+    items.resize(frameSize * 8);
+    expected.resize(frameSize * 8);
+    TEST_ASSERT_EQUAL(frameSize * 8, slow.encode(pixels.data(), pixels.size(), items.data()));
+    encodeBits(pixels.data(), pixels.size(), expected.data(), 10, 40, 30, 20);
+    for (size_t i = 0; i < items.size(); i++) {
+        TEST_ASSERT_EQUAL_HEX32(expected[i].val, items[i]);
+    }
+}
+
+// WS2812B: T0H 400 ns, T1H 800 ns, 1250 ns per bit, each +-150 ns
+void test_default_timing_is_ws2812b(void) {
+    const int tick = 1000 / (80 / LED_OUTPUT_RMT_CLOCK_DIVIDER); // ns
+    uint8_t pixels[1] = { 0x80 };
+    rmt_item32_t items[8];
+    Ws2812Encoder().encode(pixels, 1, (uint32_t *)items);
+    TEST_ASSERT_INT_WITHIN(150, 800, items[0].duration0 * tick);
+    TEST_ASSERT_INT_WITHIN(150, 1250, (items[0].duration0 + items[0].duration1) * tick);
+    TEST_ASSERT_INT_WITHIN(150, 400, items[1].duration0 * tick);
+    TEST_ASSERT_INT_WITHIN(150, 1250, (items[1].duration0 + items[1].duration1) * tick);
+}
+
+void test_rmt_output_sends_the_encoded_pixels(void) {
+    RmtOutput output(PIN, RMT_CHANNEL_1, frameSize);
+    TEST_ASSERT_TRUE(output.begin());
+    std::vector<uint8_t> pixels = randomPixels(frameSize + 30);
+    std::vector<rmt_item32_t> expected(frameSize * 8);
+    encodeBits(pixels.data(), frameSize, expected.data());
+
+    // more pixels than the strip has are cut off
+    output.show(pixels.data(), pixels.size());
+    std::vector<rmt_item32_t> &sent = hostRmtItems(RMT_CHANNEL_1);
+    TEST_ASSERT_EQUAL(frameSize * 8, sent.size());
+    for (size_t i = 0; i < sent.size(); i++) {
+        TEST_ASSERT_EQUAL_HEX32(expected[i].val, sent[i].val);
+    }
+    TEST_ASSERT_FALSE(output.busy());
+}
+
+void test_neo_pixel_output_sends_the_pixels(void) {
+    NeoPixelOutput output(MATRIX_WIDTH * MATRIX_HEIGHT, PIN, MATRIX_PIXEL_TYPE);
+    TEST_ASSERT_TRUE(output.begin());
+    std::vector<uint8_t> pixels = randomPixels(frameSize);
+    hostShows().clear();
+    output.show(pixels.data(), pixels.size());
+    TEST_ASSERT_EQUAL(1, hostShows().size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixels.data(), hostShows()[0].pixels.data(), frameSize);
+}
+
+void test_benchmark(void) {
+    const int frames = 20000;
+    std::vector<uint8_t> pixels = randomPixels(frameSize);
+    std::vector<uint32_t> items(frameSize * 8);
+    Ws2812Encoder encoder;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        pixels[i % frameSize] = i;
+        encoder.encode(pixels.data(), frameSize, items.data());
+    }
+    double table = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        pixels[i % frameSize] = i;
+        encodeBits(pixels.data(), frameSize, (rmt_item32_t *)items.data());
+    }
+    double bits = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    char message[120];
+    snprintf(message, sizeof(message), "us per frame of %u bytes: nibble table %.2f, bit by bit %.2f",
+        (unsigned)frameSize, table * 1e6 / frames, bits * 1e6 / frames);
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_encoder_is_like_bit_by_bit);
+    RUN_TEST(test_default_timing_is_ws2812b);
+    RUN_TEST(test_rmt_output_sends_the_encoded_pixels);
+    RUN_TEST(test_neo_pixel_output_sends_the_pixels);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
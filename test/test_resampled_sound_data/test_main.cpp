@@ -0,0 +1,197 @@
+// Host test (THD+N) and benchmark of ResampledSoundData: run with pio test -e native -v
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <vector>
+#include "ResampledSoundData.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const int32_t OUTPUT_RATE = 44100;
+static const uint32_t INPUT_RATES[] = {8000, 16000, 22050, 32000, 48000};
+
+static std::vector<int16_t> sine(uint32_t rate, double frequency, double amplitude, int32_t frames) {
+    std::vector<int16_t> result(frames);
+    for (int32_t i = 0; i < frames; i++) {
+        result[i] = lround(amplitude * 32767 * sin(2 * M_PI * frequency * i / rate));
+    }
+    return result;
+}
+
+// THD+N in dB: the power of what is left after removing the best fitting sine of the frequency (and DC)
+static double thd_n(const Frame *frames, int32_t len, double frequency) {
+    double sum[3][3] = {}, rhs[3] = {};
+    for (int32_t i = 0; i < len; i++) {
+        double b[3] = { sin(2 * M_PI * frequency * i / OUTPUT_RATE), cos(2 * M_PI * frequency * i / OUTPUT_RATE), 1 };
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                sum[r][c] += b[r] * b[c];
+            }
+            rhs[r] += b[r] * frames[i].channel1;
+        }
+    }
+    // solves the normal equations by Gaussian elimination
+    for (int p = 0; p < 3; p++) {
+        for (int r = p + 1; r < 3; r++) {
+            double f = sum[r][p] / sum[p][p];
+            for (int c = p; c < 3; c++) {
+                sum[r][c] -= f * sum[p][c];
+            }
+            rhs[r] -= f * rhs[p];
+        }
+    }
+    double x[3];
+    for (int r = 2; r >= 0; r--) {
+        x[r] = rhs[r];
+        for (int c = r + 1; c < 3; c++) {
+            x[r] -= sum[r][c] * x[c];
+        }
+        x[r] /= sum[r][r];
+    }
+    double signal = 0, noise = 0;
+    for (int32_t i = 0; i < len; i++) {
+        double fit = x[0] * sin(2 * M_PI * frequency * i / OUTPUT_RATE) + x[1] * cos(2 * M_PI * frequency * i / OUTPUT_RATE);
+        double residual = frames[i].channel1 - fit - x[2];
+        signal += fit * fit;
+        noise += residual * residual;
+    }
+    return 10 * log10(noise / signal);
+}
+
+static double amplitude(const Frame *frames, int32_t len) {
+    double power = 0;
+    for (int32_t i = 0; i < len; i++) {
+        power += (double) frames[i].channel1 * frames[i].channel1;
+    }
+    return sqrt(2 * power / len) / 32767;
+}
+
+void test_thd_n_of_a_1khz_sine(void) {
+    for (uint32_t rate : INPUT_RATES) {
+        std::vector<int16_t> input = sine(rate, 1000, 0.5, rate);
+        OneChannelSoundData source(input.data(), input.size());
+        ResampledSoundData sound(&source, rate, OUTPUT_RATE);
+
+        std::vector<Frame> output(OUTPUT_RATE + 100);
+        int32_t len = sound.get2ChannelData(0, output.size() * 4, (uint8_t*) output.data()) / 4;
+        TEST_ASSERT_INT_WITHIN(1, OUTPUT_RATE, len);
+
+        // without the start and the end, where the filter sees the silence around the clip
+        double result = thd_n(output.data() + 1000, len - 2000, 1000);
+        double gain = amplitude(output.data() + 1000, len - 2000) / 0.5;
+        char message[120];
+        snprintf(message, sizeof(message), "%u Hz: THD+N %.1f dB, gain %.3f", rate, result, gain);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_TRUE_MESSAGE(result < -72, message);
+        TEST_ASSERT_TRUE_MESSAGE(gain > 0.99 && gain < 1.01, message);
+    }
+}
+
+void test_passband_ends_at_0_4_of_the_lower_rate(void) {
+    for (uint32_t rate : INPUT_RATES) {
+        double frequency = std::min(rate, (uint32_t) OUTPUT_RATE) * 0.4;
+        std::vector<int16_t> input = sine(rate, frequency, 0.5, rate);
+        OneChannelSoundData source(input.data(), input.size());
+        ResampledSoundData sound(&source, rate, OUTPUT_RATE);
+        std::vector<Frame> output(OUTPUT_RATE);
+        int32_t len = sound.get2ChannelData(0, output.size() * 4, (uint8_t*) output.data()) / 4;
+        double result = thd_n(output.data() + 1000, len - 2000, frequency);
+        double gain = amplitude(output.data() + 1000, len - 2000) / 0.5;
+        char message[120];
+        snprintf(message, sizeof(message), "%.0f Hz at %u Hz: THD+N %.1f dB, gain %.3f", frequency, rate, result, gain);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_TRUE_MESSAGE(result < -72, message);
+        TEST_ASSERT_TRUE_MESSAGE(gain > 0.96 && gain < 1.01, message);
+    }
+}
+
+void test_images_of_a_tone_above_the_passband_are_filtered(void) {
+    // 7 kHz at 16 kHz is in the transition band and attenuated, but the images around 16 kHz - 7 kHz = 9 kHz and
+    // 23 kHz have to be filtered
+    std::vector<int16_t> input = sine(16000, 7000, 0.5, 16000);
+    OneChannelSoundData source(input.data(), input.size());
+    ResampledSoundData sound(&source, 16000, OUTPUT_RATE);
+    std::vector<Frame> output(OUTPUT_RATE);
+    int32_t len = sound.get2ChannelData(0, output.size() * 4, (uint8_t*) output.data()) / 4;
+    double result = thd_n(output.data() + 1000, len - 2000, 7000);
+    double gain = amplitude(output.data() + 1000, len - 2000) / 0.5;
+    char message[80];
+    snprintf(message, sizeof(message), "7 kHz at 16000 Hz: THD+N %.1f dB, gain %.3f", result, gain);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(result < -70, message);
+    TEST_ASSERT_TRUE_MESSAGE(gain > 0.66 && gain < 0.70, message);
+}
+
+// exposes the coefficient table
+class TestResampledSoundData : public ResampledSoundData {
+  public:
+    using ResampledSoundData::ResampledSoundData;
+    const int16_t *table() { return coefficients; }
+};
+
+void test_ratios_with_the_same_filter_share_the_table(void) {
+    std::vector<int16_t> input = sine(16000, 1000, 0.5, 100);
+    OneChannelSoundData source(input.data(), input.size());
+    TestResampledSoundData sound8(&source, 8000), sound16(&source, 16000), sound32(&source, 32000);
+    TestResampledSoundData sound22(&source, 22050), sound48(&source, 48000);
+    TEST_ASSERT_TRUE(sound8.table() == sound16.table());
+    TEST_ASSERT_TRUE(sound8.table() == sound32.table());
+    TEST_ASSERT_TRUE(sound8.table() != sound22.table());
+    TEST_ASSERT_TRUE(sound8.table() != sound48.table());
+    const int16_t *table = sound16.table();
+    {
+        TestResampledSoundData again(&source, 16000);
+        TEST_ASSERT_TRUE(again.table() == table);
+    }
+    TEST_ASSERT_TRUE(TestResampledSoundData(&source, 16000).table() == table);
+}
+
+void test_blocks_and_seeks_give_the_same_frames(void) {
+    std::vector<int16_t> input = sine(22050, 440, 0.8, 5000);
+    OneChannelSoundData source(input.data(), input.size(), false, Left);
+    ResampledSoundData sound(&source, 22050, OUTPUT_RATE);
+
+    std::vector<Frame> expected(12000), actual(12000);
+    int32_t len = sound.get2ChannelData(0, expected.size() * 4, (uint8_t*) expected.data()) / 4;
+    for (int32_t pos = 0; pos < len; pos += 128) {
+        sound.get2ChannelData(pos * 4, 512, (uint8_t*) (actual.data() + pos));
+    }
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), actual.data(), len * 4);
+    for (int32_t pos : {len - 1, 0, 3333, 17}) {
+        Frame frame;
+        TEST_ASSERT_EQUAL(1, sound.getData(pos, frame));
+        TEST_ASSERT_EQUAL_MEMORY(&expected[pos], &frame, 4);
+        TEST_ASSERT_EQUAL_INT16(0, frame.channel2);
+    }
+}
+
+void test_benchmark(void) {
+    for (uint32_t rate : INPUT_RATES) {
+        std::vector<int16_t> input = sine(rate, 1000, 0.5, rate * 10);
+        TwoChannelSoundData source((Frame*) input.data(), input.size() / 2);
+        ResampledSoundData sound(&source, rate, OUTPUT_RATE);
+        uint8_t block[512];
+        int32_t frames = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t pos = 0; sound.get2ChannelData(pos, sizeof(block), block) > 0; pos += sizeof(block)) {
+            frames += sizeof(block) / 4;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        char message[120];
+        snprintf(message, sizeof(message), "%u Hz: %.1f ns per frame, %.0f us per second of audio",
+            rate, seconds * 1e9 / frames, seconds * 1e6 / frames * OUTPUT_RATE);
+        TEST_MESSAGE(message);
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_thd_n_of_a_1khz_sine);
+    RUN_TEST(test_passband_ends_at_0_4_of_the_lower_rate);
+    RUN_TEST(test_images_of_a_tone_above_the_passband_are_filtered);
+    RUN_TEST(test_ratios_with_the_same_filter_share_the_table);
+    RUN_TEST(test_blocks_and_seeks_give_the_same_frames);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,282 @@
+// Host test of the screens: golden frames, the timing of the frames and a benchmark of the screen functions.
+// Run with pio test -e native -v. With SCREENS_PPM_DIR=<directory> every frame of the golden runs is also written as a
+// PPM image, with SCREENS_ANSI=1 the last frame of each run is drawn on the terminal.
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Arduino.h>
+
+// the frames are sent by the task which draws them: the shows come in the same order in every run
+#define FRAME_PIPELINE false
+
+#include "wifi_spots.h"
+#include "images.h"
+#include "ledmap.h"
+#include "effects.h"
+#include "animation.h"
+#include "settings.h"
+#include "scheduler.h"
+#include "ledoutput.h"
+#include "framebuffer.h"
+#include "textstrip.h"
+#include "screens.h"
+
+void presentFrame() {
+  frameBuffer.present();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static int currentScreen = 0;
+
+// what Core0loopTask does for ms of virtual time: the frames which have been shown, with their time
+static std::vector<HostFrame> runScreen(int mode, unsigned long ms) {
+    screenMode = mode;
+    if (mode != currentScreen) {
+        leaveScreen(currentScreen);
+        currentScreen = mode;
+        enterScreen(currentScreen);
+        scheduler.restart(currentScreen);
+    }
+
+    hostShows().clear();
+    unsigned long start = millis();
+    while (millis() - start < ms) {
+        scheduler.frame(screens[currentScreen]);
+    }
+
+    std::vector<HostFrame> frames;
+    for (const HostShow &show : hostShows()) {
+        frames.emplace_back(matrix, show);
+    }
+    return frames;
+}
+
+static void writeFrames(int mode, const std::vector<HostFrame> &frames) {
+    const char *directory = getenv("SCREENS_PPM_DIR");
+    for (size_t i = 0; directory != NULL && i < frames.size(); i++) {
+        std::string path = std::string(directory) + "/screen" + std::to_string(mode) + "_" +
+            std::to_string(frames[i].time / 1000) + ".ppm";
+        FILE *file = fopen(path.c_str(), "wb");
+        TEST_ASSERT_NOT_NULL(file);
+        frames[i].writePpm(file, 8);
+        fclose(file);
+    }
+    if (getenv("SCREENS_ANSI") != NULL && !frames.empty()) {
+        printf("screen %d at %llu ms:\n", mode, (unsigned long long)(frames.back().time / 1000));
+        frames.back().writeAnsi(stdout);
+    }
+}
+
+// FNV-1a over the hashes of the frames
+static uint32_t hashOf(const std::vector<HostFrame> &frames) {
+    uint32_t hash = 2166136261UL;
+    for (const HostFrame &frame : frames) {
+        uint32_t frameHash = frame.hash();
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash = (hash ^ (uint8_t)(frameHash >> shift)) * 16777619UL;
+        }
+    }
+    return hash;
+}
+
+static uint32_t brightest(const HostFrame &frame) {
+    uint32_t result = 0;
+    for (uint32_t color : frame.pixels) {
+        result = max(result, color);
+    }
+    return result;
+}
+
+// the screens in the order of the buttons. When a screen is changed on purpose, check its frames with
+// SCREENS_PPM_DIR and take over the new line which the test prints.
+struct goldenRun {
+    int screen;
+    unsigned long duration; // ms
+    size_t shows;
+    uint32_t hash;
+};
+
+static const goldenRun golden[] = {
+    { 1, 2000, 1, 0x45580bc5 },
+    { 2, 61000, 1801, 0xa2979520 },
+    { 3, 5000, 50, 0xa4082358 },
+    { 4, 1000, 1, 0x8fdf2ce6 },
+    { 5, 1000, 1, 0x075d4651 },
+    { 6, 2000, 11, 0xc230eb25 },
+    { 7, 1000, 1, 0xed38dead },
+    { 8, 2000, 1, 0x33195057 },
+    { 9, 2000, 1, 0xe1b195ad },
+};
+
+void test_golden_frames(void) {
+    setScreenText(currentTime, sizeof(currentTime), "01:04");
+    setScreenText(currentMessage, sizeof(currentMessage), "love you");
+    int failures = 0;
+    for (const goldenRun &run : golden) {
+        std::vector<HostFrame> frames = runScreen(run.screen, run.duration);
+        writeFrames(run.screen, frames);
+        uint32_t hash = hashOf(frames);
+        if (frames.size() != run.shows || hash != run.hash) {
+            printf("screen %d changed: { %d, %lu, %zu, 0x%08x },\n", run.screen, run.screen, run.duration, frames.size(),
+                hash);
+            failures++;
+        }
+    }
+    TEST_ASSERT_EQUAL(0, failures);
+}
+
+void test_static_text_starts_at_column_2(void) {
+    setScreenText(currentTime, sizeof(currentTime), "12:34");
+    std::vector<HostFrame> frames = runScreen(1, 1000);
+    TEST_ASSERT_EQUAL(1, frames.size());
+    // the frame does not change, so it is not sent again
+    TEST_ASSERT_EQUAL(0, runScreen(1, 1000).size());
+
+    const HostFrame &frame = frames[0];
+    for (int y = 0; y < MATRIX_HEIGHT; y++) {
+        TEST_ASSERT_EQUAL_HEX32(0, frame.pixel(0, y));
+        TEST_ASSERT_EQUAL_HEX32(0, frame.pixel(1, y));
+    }
+    // red at brightness 20
+    uint32_t color = brightest(frame);
+    TEST_ASSERT_EQUAL_HEX32(0, color & 0xFFFF);
+    TEST_ASSERT_INT_WITHIN(3, 255 * 21 / 256, color >> 16);
+}
+
+void test_text_scrolls_one_column_per_100_ms(void) {
+    setScreenText(currentMessage, sizeof(currentMessage), "hello world");
+    runScreen(3, 10);
+    std::vector<HostFrame> frames = runScreen(3, 3000);
+    TEST_ASSERT_INT_WITHIN(1, 30, frames.size());
+
+    for (size_t i = 1; i < frames.size(); i++) {
+        // the text moves one column to the left
+        for (int y = 0; y < MATRIX_HEIGHT; y++) {
+            for (int x = 0; x < MATRIX_WIDTH - 1; x++) {
+                TEST_ASSERT_EQUAL_HEX32(frames[i - 1].pixel(x + 1, y), frames[i].pixel(x, y));
+            }
+        }
+        // the scheduler wakes up in whole ms: a frame can be up to 1 ms early
+        int64_t interval = frames[i].time - frames[i - 1].time;
+        TEST_ASSERT_INT_WITHIN(1000, 100000, interval);
+    }
+}
+
+// updateMessage() on core 1 replaces the message while the message screen draws it: each copy is one message
+void test_message_from_core_1_is_copied_whole(void) {
+    const char *messages[] = { "aaaa", "bbbbbbbbbbbbbbbbbbbb" };
+    std::atomic<bool> done{false};
+    std::thread core1([&]() {
+        for (int i = 0; !done; i++) {
+            setScreenText(currentMessage, sizeof(currentMessage), messages[i % 2]);
+        }
+    });
+    int seen[2] = {};
+    for (int i = 0; i < 200000 || seen[0] == 0 || seen[1] == 0; i++) {
+        if (i % 1000 == 0) {
+            std::this_thread::yield();
+        }
+        char text[sizeof(currentMessage)];
+        copyScreenText(text, currentMessage, sizeof(text));
+        size_t length = strlen(text);
+        if (length == 4 || length == 20) {
+            int which = length == 4 ? 0 : 1;
+            TEST_ASSERT_EQUAL_STRING(messages[which], text);
+            seen[which]++;
+        } else {
+            TEST_ASSERT_EQUAL_STRING("hello world", text);
+        }
+    }
+    done = true;
+    core1.join();
+    TEST_ASSERT_TRUE(seen[0] > 0 && seen[1] > 0);
+}
+
+void test_animation_is_shown_at_the_frame_rate(void) {
+    std::vector<HostFrame> frames = runScreen(2, 1000);
+    TEST_ASSERT_INT_WITHIN(1, FRAME_RATE, frames.size());
+    for (size_t i = 1; i < frames.size(); i++) {
+        int64_t interval = frames[i].time - frames[i - 1].time;
+        TEST_ASSERT_INT_WITHIN(1000, 1000000 / FRAME_RATE, interval);
+    }
+}
+
+void test_static_screen_is_shown_once(void) {
+    std::vector<HostFrame> frames = runScreen(7, 2000);
+    TEST_ASSERT_EQUAL(1, frames.size());
+    TEST_ASSERT_EQUAL(0, runScreen(7, 2000).size());
+}
+
+void test_button_redraws_an_idle_screen_at_once(void) {
+    runScreen(9, 2000);
+    uint32_t framesBefore = scheduler.frames();
+    TEST_ASSERT_EQUAL(0, runScreen(9, 3000).size());
+    // an idle screen is only drawn once per FRAME_IDLE_TIMEOUT
+    TEST_ASSERT_INT_WITHIN(1, 3000 / FRAME_IDLE_TIMEOUT, scheduler.frames() - framesBefore);
+
+    // what nextISR() does on the brightness screen
+    BRIGHTNESS_DAY += 10;
+    scheduler.wakeFromISR();
+    uint64_t pressed = hostMicros();
+    std::vector<HostFrame> frames = runScreen(9, 100);
+    TEST_ASSERT_EQUAL(1, frames.size());
+    TEST_ASSERT_TRUE(frames[0].time - pressed < 1000);
+    BRIGHTNESS_DAY -= 10;
+}
+
+// real time of the screen functions alone and with the present() of the frame
+void test_benchmark(void) {
+    const int frameCount = 3000;
+    for (int mode = 1; mode <= LAST_SCREEN; mode++) {
+        runScreen(mode, 0);
+        double tickTime = 0;
+        double frameTime = 0;
+        unsigned long now = 0;
+        for (int i = 0; i < frameCount; i++, now += 1000 / FRAME_RATE) {
+            auto start = std::chrono::steady_clock::now();
+            screens[mode](now);
+            auto ticked = std::chrono::steady_clock::now();
+            presentFrame();
+            auto end = std::chrono::steady_clock::now();
+            tickTime += std::chrono::duration<double>(ticked - start).count();
+            frameTime += std::chrono::duration<double>(end - start).count();
+        }
+        hostShows().clear();
+        scheduler.frame([](unsigned long now) {}); // ends the idle state of the settings screens
+
+        char message[120];
+        snprintf(message, sizeof(message), "screen %d: tick %.2f us, tick + present %.2f us = %.0f frames per s",
+            mode, tickTime * 1e6 / frameCount, frameTime * 1e6 / frameCount, frameCount / frameTime);
+        TEST_MESSAGE(message);
+    }
+}
+
+int main(int argc, char **argv) {
+    // setup() of the firmware without the Bluetooth, the network and the settings in the flash
+    Serial.isCaptured = true; // the reports of the firmware are not part of the test output
+    xTaskGetCurrentTaskHandle()->virtualTime = true;
+    matrix.begin();
+    matrix.setTextWrap(false);
+    matrix.setBrightness(BRIGHTNESS_DAY);
+    ledMap.begin();
+    effectRunner.begin();
+    neoPixelOutput.begin();
+    frameBuffer.begin(neoPixelOutput);
+    scheduler.begin(presentFrame);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_golden_frames);
+    RUN_TEST(test_static_text_starts_at_column_2);
+    RUN_TEST(test_text_scrolls_one_column_per_100_ms);
+    RUN_TEST(test_message_from_core_1_is_copied_whole);
+    RUN_TEST(test_animation_is_shown_at_the_frame_rate);
+    RUN_TEST(test_static_screen_is_shown_once);
+    RUN_TEST(test_button_redraws_an_idle_screen_at_once);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
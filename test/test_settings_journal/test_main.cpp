@@ -0,0 +1,288 @@
+// Host test of SettingsJournal: replay, failed writes, power loss at every byte and one year of wear.
+// Run with pio test -e native -v
+#include <unity.h>
+#include <vector>
+#include "settings_journal.h"
+
+// NOR flash in RAM which counts the erases per sector. A power loss can be simulated: after powerBudget bytes
+// have been written the flash stops, so the write in progress is torn and every later write or erase fails.
+class RamFlashBackend : public FlashBackend {
+  public:
+    static const int64_t UNLIMITED = -1;
+    int64_t powerBudget = UNLIMITED;
+    uint32_t failWrites = 0; // the next writes fail without writing anything
+
+    RamFlashBackend(uint32_t sectorSize, uint32_t sectorCount)
+      : size(sectorSize), count(sectorCount), memory(sectorSize * sectorCount, 0xFF), erases(sectorCount, 0) {}
+
+    uint32_t sectorSize() { return size; }
+    uint32_t sectorCount() { return count; }
+    uint32_t eraseCount(uint32_t sector) { return erases[sector]; }
+
+    bool read(uint32_t address, void *data, uint32_t len) {
+      memcpy(data, memory.data() + address, len);
+      return true;
+    }
+
+    bool write(uint32_t address, const void *data, uint32_t len) {
+      if (failWrites > 0) {
+        failWrites--;
+        return false;
+      }
+      for (uint32_t i = 0; i < len; i++) {
+        if (powerBudget == 0) {
+          return false;
+        }
+        if (powerBudget > 0) {
+          powerBudget--;
+        }
+        // we can only clear bits
+        memory[address + i] &= ((const uint8_t *)data)[i];
+      }
+      return true;
+    }
+
+    bool erase(uint32_t sector) {
+      if (powerBudget == 0) {
+        return false;
+      }
+      memset(memory.data() + sector * size, 0xFF, size);
+      erases[sector]++;
+      return true;
+    }
+
+  private:
+    uint32_t size;
+    uint32_t count;
+    std::vector<uint8_t> memory;
+    std::vector<uint32_t> erases;
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint16_t readTime(SettingsJournal &journal) {
+    uint16_t value = 0xFFFF;
+    journal.read(3, &value, 2);
+    return value;
+}
+
+void test_values_are_replayed(void) {
+    RamFlashBackend flash(4096, 4);
+    SettingsJournal journal;
+    TEST_ASSERT_TRUE(journal.begin(&flash));
+    TEST_ASSERT_TRUE(journal.isEmpty());
+    uint8_t brightness = 40;
+    char message[24] = "wake up";
+    TEST_ASSERT_TRUE(journal.write(2, &brightness, 1));
+    TEST_ASSERT_TRUE(journal.write(5, message, sizeof(message)));
+    brightness = 80;
+    TEST_ASSERT_TRUE(journal.write(2, &brightness, 1));
+
+    SettingsJournal restarted;
+    TEST_ASSERT_TRUE(restarted.begin(&flash));
+    uint8_t value = 0;
+    char text[24] = "";
+    TEST_ASSERT_TRUE(restarted.read(2, &value, 1));
+    TEST_ASSERT_EQUAL(80, value);
+    TEST_ASSERT_TRUE(restarted.read(5, text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("wake up", text);
+    TEST_ASSERT_FALSE(restarted.read(2, text, 2)); // a different length
+    TEST_ASSERT_FALSE(restarted.read(4, &value, 1)); // never written
+    TEST_ASSERT_FALSE(restarted.write(0, &value, 1));
+    TEST_ASSERT_FALSE(restarted.write(SETTINGS_JOURNAL_KEYS, &value, 1));
+}
+
+void test_unchanged_value_is_not_written(void) {
+    RamFlashBackend flash(4096, 4);
+    SettingsJournal journal;
+    journal.begin(&flash);
+    uint16_t time = 1230;
+    journal.write(3, &time, 2);
+    flash.failWrites = 1;
+    TEST_ASSERT_TRUE(journal.write(3, &time, 2));
+    TEST_ASSERT_EQUAL(1, flash.failWrites);
+}
+
+void test_failed_write_is_written_by_the_retry(void) {
+    RamFlashBackend flash(4096, 4);
+    SettingsJournal journal;
+    journal.begin(&flash);
+    uint16_t time = 1230;
+    journal.write(3, &time, 2);
+
+    time = 1231;
+    flash.failWrites = 1;
+    TEST_ASSERT_FALSE(journal.write(3, &time, 2));
+    TEST_ASSERT_EQUAL(1230, readTime(journal));
+    TEST_ASSERT_TRUE(journal.write(3, &time, 2));
+    TEST_ASSERT_EQUAL(1231, readTime(journal));
+
+    SettingsJournal restarted;
+    TEST_ASSERT_TRUE(restarted.begin(&flash));
+    TEST_ASSERT_EQUAL(1231, readTime(restarted));
+}
+
+void test_failed_compaction_is_written_by_the_retry(void) {
+    RamFlashBackend flash(256, 2);
+    SettingsJournal journal;
+    journal.begin(&flash);
+    uint16_t time = 0;
+    while (journal.compactions() == 0) {
+        time++;
+        journal.write(3, &time, 2);
+    }
+    // fill the sector again, then the write which needs the compaction fails
+    uint32_t compactions = journal.compactions();
+    for (int i = 0; i < 100 && journal.compactions() == compactions; i++) {
+        flash.failWrites = 1;
+        time++;
+        if (!journal.write(3, &time, 2)) {
+            TEST_ASSERT_EQUAL(time - 1, readTime(journal));
+            TEST_ASSERT_TRUE(journal.write(3, &time, 2));
+        }
+        TEST_ASSERT_EQUAL(time, readTime(journal));
+    }
+    SettingsJournal restarted;
+    TEST_ASSERT_TRUE(restarted.begin(&flash));
+    TEST_ASSERT_EQUAL(time, readTime(restarted));
+}
+
+// writes of 3 keys with a compaction after a few of them
+static const int POWER_LOSS_WRITES = 12;
+
+static bool powerLossWrite(SettingsJournal &journal, int i) {
+    uint8_t value[8];
+    memset(value, i + 1, sizeof(value));
+    return journal.write(1 + i % 3, value, 1 + i % 3 * 3);
+}
+
+void test_power_loss_at_every_byte(void) {
+    // the number of bytes which all writes need without a power loss
+    RamFlashBackend reference(64, 3);
+    SettingsJournal journal;
+    journal.begin(&reference);
+    reference.powerBudget = 1 << 30;
+    for (int i = 0; i < POWER_LOSS_WRITES; i++) {
+        powerLossWrite(journal, i);
+    }
+    int64_t total = (1 << 30) - reference.powerBudget;
+    TEST_ASSERT_TRUE(journal.compactions() >= 2);
+
+    int torn = 0; // restarts which found a damaged record
+    for (int64_t budget = 0; budget <= total; budget++) {
+        RamFlashBackend flash(64, 3);
+        SettingsJournal before;
+        before.begin(&flash);
+        flash.powerBudget = budget;
+        int committed = 0; // writes which have returned true
+        while (committed < POWER_LOSS_WRITES && powerLossWrite(before, committed)) {
+            committed++;
+        }
+
+        // after the restart every key has the last committed value or the one of the write of the power loss
+        flash.powerBudget = RamFlashBackend::UNLIMITED;
+        SettingsJournal after;
+        Serial.text.clear();
+        Serial.isCaptured = true;
+        TEST_ASSERT_TRUE(after.begin(&flash));
+        Serial.isCaptured = false;
+        if (!Serial.text.empty()) {
+            torn++;
+        }
+        for (uint8_t key = 1; key <= 3; key++) {
+            uint8_t value[8];
+            uint8_t len = 1 + (key - 1) * 3;
+            int last = -1;
+            for (int i = 0; i < committed; i++) {
+                if (1 + i % 3 == key) {
+                    last = i;
+                }
+            }
+            if (!after.read(key, value, len)) {
+                TEST_ASSERT_EQUAL(-1, last);
+                continue;
+            }
+            bool isTorn = committed < POWER_LOSS_WRITES && 1 + committed % 3 == key;
+            TEST_ASSERT_TRUE(value[0] == last + 1 || (isTorn && value[0] == committed + 1));
+            for (int i = 1; i < len; i++) {
+                TEST_ASSERT_EQUAL(value[0], value[i]);
+            }
+        }
+        // and the journal goes on
+        uint8_t value = 99;
+        TEST_ASSERT_TRUE(after.write(1, &value, 1));
+        SettingsJournal again;
+        TEST_ASSERT_TRUE(again.begin(&flash));
+        TEST_ASSERT_TRUE(again.read(1, &value, 1));
+        TEST_ASSERT_EQUAL(99, value);
+    }
+    char text[100];
+    snprintf(text, sizeof(text), "%d power losses, %d torn records compacted at the restart", (int) total + 1, torn);
+    TEST_MESSAGE(text);
+    TEST_ASSERT_TRUE(torn > 0);
+}
+
+// the time changes every minute for a year on the 16 KB partition of partitions.csv
+void test_one_year_of_wear(void) {
+    RamFlashBackend flash(SPI_FLASH_SEC_SIZE, 4);
+    SettingsJournal journal;
+    journal.begin(&flash);
+    uint8_t brightness = 50;
+    char message[24] = "good morning";
+    journal.write(2, &brightness, 1);
+    journal.write(5, message, sizeof(message));
+
+    const uint32_t commits = 365 * 24 * 60;
+    for (uint32_t minute = 0; minute < commits; minute++) {
+        uint16_t time = (minute / 60 % 24) * 100 + minute % 60;
+        TEST_ASSERT_TRUE(journal.write(3, &time, 2));
+    }
+    uint32_t least = UINT32_MAX, most = 0;
+    for (uint32_t sector = 0; sector < flash.sectorCount(); sector++) {
+        least = std::min(least, flash.eraseCount(sector));
+        most = std::max(most, flash.eraseCount(sector));
+    }
+    char text[160];
+    snprintf(text, sizeof(text), "%u commits: %u compactions, %u to %u erases per sector", commits, journal.compactions(), least, most);
+    TEST_MESSAGE(text);
+    TEST_ASSERT_TRUE(most - least <= 1);
+    // far below the 100000 erase cycles of the flash
+    TEST_ASSERT_TRUE(most < 300);
+
+    SettingsJournal restarted;
+    TEST_ASSERT_TRUE(restarted.begin(&flash));
+    TEST_ASSERT_EQUAL(2359, readTime(restarted));
+    TEST_ASSERT_TRUE(restarted.read(5, text, sizeof(message)));
+    TEST_ASSERT_EQUAL_STRING("good morning", text);
+}
+
+void test_partition_backend(void) {
+    hostAddPartition("settings", 4 * SPI_FLASH_SEC_SIZE);
+    PartitionFlashBackend partition("settings");
+    TEST_ASSERT_TRUE(partition.isAvailable());
+    TEST_ASSERT_EQUAL(4, partition.sectorCount());
+    SettingsJournal journal;
+    TEST_ASSERT_TRUE(journal.begin(&partition));
+    uint16_t time = 745;
+    TEST_ASSERT_TRUE(journal.write(3, &time, 2));
+    SettingsJournal restarted;
+    TEST_ASSERT_TRUE(restarted.begin(&partition));
+    TEST_ASSERT_EQUAL(745, readTime(restarted));
+
+    PartitionFlashBackend missing("missing");
+    TEST_ASSERT_FALSE(missing.isAvailable());
+    TEST_ASSERT_FALSE(journal.begin(&missing));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_values_are_replayed);
+    RUN_TEST(test_unchanged_value_is_not_written);
+    RUN_TEST(test_failed_write_is_written_by_the_retry);
+    RUN_TEST(test_failed_compaction_is_written_by_the_retry);
+    RUN_TEST(test_power_loss_at_every_byte);
+    RUN_TEST(test_one_year_of_wear);
+    RUN_TEST(test_partition_backend);
+    return UNITY_END();
+}
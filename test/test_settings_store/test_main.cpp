@@ -0,0 +1,297 @@
+// Host test of SettingsStore with the EEPROM and the journal stand-ins: the migrations, the CRC, the coalescing of
+// changes and failed commits. Run with pio test -e native -v
+#include <unity.h>
+#include <Arduino.h>
+
+#include "wifi_spots.h"
+#include "images.h"
+#include "settings.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// an erased EEPROM and, if partition, an erased settings partition of the size in partitions.csv
+static void eraseFlash(bool partition) {
+    EEPROM.begin(sizeof(settingsLayout));
+    memset(EEPROM.getDataPtr(), 0xFF, EEPROM.length());
+    EEPROM.commits = 0;
+    EEPROM.failCommits = 0;
+    EEPROM.onCommit = nullptr;
+    if (partition) {
+        hostAddPartition(SETTINGS_PARTITION, 4 * SPI_FLASH_SEC_SIZE);
+    } else if (hostPartitions().count(SETTINGS_PARTITION)) {
+        delete[] hostPartitions()[SETTINGS_PARTITION].memory;
+        hostPartitions().erase(SETTINGS_PARTITION);
+    }
+}
+
+static esp_partition_t &partition() {
+    return hostPartitions()[SETTINGS_PARTITION];
+}
+
+static void advance(unsigned long ms) {
+    hostMicros() += ms * 1000ULL;
+}
+
+// the bytes of the firmware before the settings store, see SettingsStore::loadLegacy()
+static void writeLegacy(uint8_t color, uint8_t brightness, const char *message, uint8_t hour, uint8_t minute) {
+    uint8_t *bytes = EEPROM.getDataPtr();
+    bytes[0] = color;
+    bytes[1] = brightness;
+    memset(bytes + 2, ' ', byteSizeForMessage);
+    memcpy(bytes + 2, message, strlen(message));
+    bytes[22] = hour;
+    bytes[23] = minute;
+    bytes[24] = 10;
+    bytes[25] = 20;
+    bytes[26] = 30;
+}
+
+static void assertDefaults(const settingsLayout &layout) {
+    TEST_ASSERT_EQUAL_UINT8(0, layout.favoriteColorNum);
+    TEST_ASSERT_EQUAL_UINT8(50, layout.brightness);
+    TEST_ASSERT_EQUAL_MEMORY("                    ", layout.message, byteSizeForMessage);
+    TEST_ASSERT_EQUAL_UINT8(1, layout.hour);
+    TEST_ASSERT_EQUAL_UINT8(4, layout.minute);
+}
+
+void test_legacy_settings_are_migrated(void) {
+    eraseFlash(false);
+    writeLegacy(3, 70, "hello", 7, 30);
+    SettingsStore store;
+    // migrated, not loaded: the new layout is committed right away
+    TEST_ASSERT_FALSE(store.begin());
+    TEST_ASSERT_EQUAL(1, EEPROM.commits);
+    TEST_ASSERT_FALSE(store.isDirty());
+    const settingsLayout &layout = store.get();
+    TEST_ASSERT_EQUAL_UINT8(3, layout.favoriteColorNum);
+    TEST_ASSERT_EQUAL_UINT8(70, layout.brightness);
+    TEST_ASSERT_EQUAL_MEMORY("hello               ", layout.message, byteSizeForMessage);
+    TEST_ASSERT_EQUAL_UINT8(7, layout.hour);
+    TEST_ASSERT_EQUAL_UINT8(30, layout.minute);
+    TEST_ASSERT_EQUAL_UINT8(10, layout.randomGreen);
+    TEST_ASSERT_EQUAL_UINT8(20, layout.randomRed);
+    TEST_ASSERT_EQUAL_UINT8(30, layout.randomBlue);
+
+    // the crc is only calculated for the copy in the EEPROM
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL_MEMORY(&layout, &reloaded.get(), offsetof(settingsLayout, crc));
+}
+
+void test_invalid_legacy_bytes_give_the_defaults(void) {
+    // erased, a color which does not exist, a brightness which is too low, an hour and a minute which are too high
+    const uint8_t invalid[][4] = { { 0xFF, 0xFF, 0xFF, 0xFF }, { maxNumOfColors, 50, 1, 4 }, { 0, 9, 1, 4 },
+                                   { 0, 50, 24, 4 }, { 0, 50, 1, 60 } };
+    for (const uint8_t *bytes : invalid) {
+        eraseFlash(false);
+        if (bytes[0] != 0xFF) {
+            writeLegacy(bytes[0], bytes[1], "", bytes[2], bytes[3]);
+        }
+        SettingsStore store;
+        TEST_ASSERT_FALSE(store.begin());
+        assertDefaults(store.get());
+    }
+}
+
+void test_crc_mismatch_falls_back_to_the_defaults(void) {
+    eraseFlash(false);
+    SettingsStore store;
+    store.begin();
+    store.setFavoriteColor(5);
+    store.setMessage("checked");
+    store.commit();
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL_UINT8(5, reloaded.get().favoriteColorNum);
+
+    // one bit of the message: the version is still right but the CRC is not, and the bytes are no legacy
+    // settings either because the favorite color is in the place of the legacy brightness
+    EEPROM.getDataPtr()[offsetof(settingsLayout, message) + 2] ^= 0x01;
+    SettingsStore damaged;
+    TEST_ASSERT_FALSE(damaged.begin());
+    assertDefaults(damaged.get());
+
+    EEPROM.getDataPtr()[0] = SETTINGS_VERSION + 1;
+    SettingsStore newer;
+    TEST_ASSERT_FALSE(newer.begin());
+    assertDefaults(newer.get());
+}
+
+void test_changes_are_coalesced(void) {
+    eraseFlash(false);
+    SettingsStore store;
+    store.begin();
+    uint32_t commits = store.commits();
+
+    // e.g. the buttons of the brightness screen: each press restarts the delay
+    for (uint8_t brightness = 20; brightness <= 100; brightness += 10) {
+        store.setBrightness(brightness);
+        advance(SETTINGS_COMMIT_DELAY - 1);
+        store.loop();
+    }
+    TEST_ASSERT_EQUAL(commits, store.commits());
+    TEST_ASSERT_TRUE(store.isDirty());
+    advance(1);
+    store.loop();
+    TEST_ASSERT_EQUAL(commits + 1, store.commits());
+    TEST_ASSERT_FALSE(store.isDirty());
+
+    // the same value again does not make the settings dirty
+    store.setBrightness(100);
+    store.setTime(1, 4);
+    TEST_ASSERT_FALSE(store.isDirty());
+    advance(SETTINGS_COMMIT_DELAY);
+    store.loop();
+    TEST_ASSERT_EQUAL(commits + 1, store.commits());
+
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL_UINT8(100, reloaded.get().brightness);
+}
+
+void test_change_during_a_commit_keeps_the_store_dirty(void) {
+    eraseFlash(false);
+    SettingsStore store;
+    store.begin();
+    store.setBrightness(60);
+
+    // the other core changes the settings after the snapshot has been taken
+    EEPROM.onCommit = [&]() {
+        EEPROM.onCommit = nullptr;
+        store.setBrightness(90);
+    };
+    uint32_t commits = store.commits();
+    store.commit();
+    TEST_ASSERT_EQUAL(commits + 1, store.commits());
+    TEST_ASSERT_TRUE(store.isDirty());
+    SettingsStore stale;
+    stale.begin();
+    TEST_ASSERT_EQUAL_UINT8(60, stale.get().brightness);
+
+    advance(SETTINGS_COMMIT_DELAY);
+    store.loop();
+    TEST_ASSERT_FALSE(store.isDirty());
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL_UINT8(90, reloaded.get().brightness);
+}
+
+void test_eeprom_settings_are_moved_to_the_journal(void) {
+    eraseFlash(false);
+    SettingsStore old;
+    old.begin();
+    old.setFavoriteColor(6);
+    old.setMessage("from the eeprom");
+    old.setTime(23, 59);
+    old.setRandomColor(1, 2, 3);
+    old.commit();
+
+    // a firmware with the settings partition: the first start takes over the EEPROM
+    hostAddPartition(SETTINGS_PARTITION, 4 * SPI_FLASH_SEC_SIZE);
+    SettingsStore store;
+    TEST_ASSERT_FALSE(store.begin());
+    TEST_ASSERT_EQUAL_MEMORY(&old.get(), &store.get(), offsetof(settingsLayout, crc));
+    TEST_ASSERT_EQUAL(1, store.commits());
+
+    // from now on the EEPROM is not used any more
+    memset(EEPROM.getDataPtr(), 0xFF, EEPROM.length());
+    uint32_t eepromCommits = EEPROM.commits;
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL_UINT8(6, reloaded.get().favoriteColorNum);
+    TEST_ASSERT_EQUAL_MEMORY("from the eeprom", reloaded.get().message, 15);
+    TEST_ASSERT_EQUAL_UINT8(23, reloaded.get().hour);
+    TEST_ASSERT_EQUAL_UINT8(59, reloaded.get().minute);
+    TEST_ASSERT_EQUAL_UINT8(3, reloaded.get().randomBlue);
+    reloaded.setBrightness(30);
+    reloaded.commit();
+    TEST_ASSERT_EQUAL(eepromCommits, EEPROM.commits);
+}
+
+void test_legacy_settings_are_moved_to_the_journal(void) {
+    eraseFlash(true);
+    writeLegacy(2, 40, "legacy", 12, 0);
+    SettingsStore store;
+    TEST_ASSERT_FALSE(store.begin());
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL_UINT8(2, reloaded.get().favoriteColorNum);
+    TEST_ASSERT_EQUAL_UINT8(40, reloaded.get().brightness);
+    TEST_ASSERT_EQUAL_MEMORY("legacy", reloaded.get().message, 6);
+    TEST_ASSERT_EQUAL_UINT8(12, reloaded.get().hour);
+}
+
+void test_failed_eeprom_commit_waits_for_the_delay(void) {
+    eraseFlash(false);
+    SettingsStore store;
+    store.begin();
+    uint32_t commits = EEPROM.commits;
+
+    store.setBrightness(77);
+    EEPROM.failCommits = 2;
+    advance(SETTINGS_COMMIT_DELAY);
+    store.loop();
+    TEST_ASSERT_EQUAL(commits + 1, EEPROM.commits);
+    TEST_ASSERT_TRUE(store.isDirty());
+
+    // the next passes of the loop do not try again
+    for (int pass = 0; pass < 100; pass++) {
+        store.loop();
+        advance(10);
+    }
+    TEST_ASSERT_EQUAL(commits + 1, EEPROM.commits);
+
+    advance(SETTINGS_COMMIT_DELAY);
+    store.loop();
+    TEST_ASSERT_EQUAL(commits + 2, EEPROM.commits);
+    advance(SETTINGS_COMMIT_DELAY);
+    store.loop();
+    TEST_ASSERT_EQUAL(commits + 3, EEPROM.commits);
+    TEST_ASSERT_FALSE(store.isDirty());
+
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL_UINT8(77, reloaded.get().brightness);
+}
+
+void test_failed_journal_commit_does_not_compact_on_every_pass(void) {
+    eraseFlash(true);
+    SettingsStore store;
+    store.begin();
+    uint32_t erases = partition().erases;
+
+    store.setMessage("flash is failing");
+    partition().failWrites = 1000;
+    advance(SETTINGS_COMMIT_DELAY);
+    for (int pass = 0; pass < 100; pass++) {
+        store.loop();
+        advance(10);
+    }
+    // one failed record and one failed compaction, not one of each per pass
+    TEST_ASSERT_TRUE(partition().erases - erases <= 1);
+    TEST_ASSERT_TRUE(store.isDirty());
+
+    partition().failWrites = 0;
+    advance(SETTINGS_COMMIT_DELAY);
+    store.loop();
+    TEST_ASSERT_FALSE(store.isDirty());
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL_MEMORY("flash is failing", reloaded.get().message, 16);
+}
+
+int main(int argc, char **argv) {
+    Serial.isCaptured = true;
+    UNITY_BEGIN();
+    RUN_TEST(test_legacy_settings_are_migrated);
+    RUN_TEST(test_invalid_legacy_bytes_give_the_defaults);
+    RUN_TEST(test_crc_mismatch_falls_back_to_the_defaults);
+    RUN_TEST(test_changes_are_coalesced);
+    RUN_TEST(test_change_during_a_commit_keeps_the_store_dirty);
+    RUN_TEST(test_eeprom_settings_are_moved_to_the_journal);
+    RUN_TEST(test_legacy_settings_are_moved_to_the_journal);
+    RUN_TEST(test_failed_eeprom_commit_waits_for_the_delay);
+    RUN_TEST(test_failed_journal_commit_does_not_compact_on_every_pass);
+    return UNITY_END();
+}
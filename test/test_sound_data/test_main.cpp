@@ -0,0 +1,111 @@
+// Host test and benchmark of the bulk kernels of SoundData::get2ChannelData: run with pio test -e native -v
+#include <unity.h>
+#include <chrono>
+#include <stdlib.h>
+#include "SoundData.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const int32_t FRAMES = 44100;
+static Frame stereo[FRAMES];
+static int16_t mono16[FRAMES];
+static int8_t mono8[FRAMES];
+
+// the conversion before the bulk kernels: one virtual getData() per frame until the data ends
+static int32_t per_frame_2channel_data(SoundData &sound, int32_t pos, int32_t len, uint8_t *data) {
+    Frame *frames = (Frame*) data;
+    int32_t result_len = 0;
+    for (int32_t j = 0; j < len / 4; j++) {
+        if (sound.getData(pos / 4 + j, frames[j]) == 0) {
+            break;
+        }
+        result_len += 4;
+    }
+    return result_len;
+}
+
+static void fill_test_data() {
+    srand(1);
+    for (int32_t j = 0; j < FRAMES; j++) {
+        stereo[j] = Frame(rand() - RAND_MAX / 2, rand() - RAND_MAX / 2);
+        mono16[j] = rand();
+        mono8[j] = rand();
+    }
+}
+
+// compares the kernel with the per frame conversion for blocks in the data, at its end and after it
+static void check_same_as_per_frame(SoundData &sound, int32_t frames) {
+    uint8_t expected[512], actual[512];
+    int32_t positions[] = {0, 4, 508, (frames - 100) * 4, (frames - 1) * 4, frames * 4, (frames + 10) * 4};
+    for (int32_t pos : positions) {
+        memset(expected, 0x55, sizeof(expected));
+        memset(actual, 0x55, sizeof(actual));
+        int32_t expected_len = per_frame_2channel_data(sound, pos, 512, expected);
+        int32_t actual_len = sound.get2ChannelData(pos, 512, actual);
+        TEST_ASSERT_EQUAL(expected_len, actual_len);
+        TEST_ASSERT_EQUAL_MEMORY(expected, actual, sizeof(actual));
+    }
+}
+
+void test_two_channels_is_same_as_per_frame(void) {
+    TwoChannelSoundData sound(stereo, FRAMES);
+    check_same_as_per_frame(sound, FRAMES);
+}
+
+void test_one_channel_is_same_as_per_frame(void) {
+    for (ChannelInfo info : {Both, Left, Right}) {
+        OneChannelSoundData sound(mono16, FRAMES, false, info);
+        check_same_as_per_frame(sound, FRAMES);
+    }
+}
+
+void test_one_channel_8bit_is_same_as_per_frame(void) {
+    for (ChannelInfo info : {Both, Left, Right}) {
+        OneChannel8BitSoundData sound(mono8, FRAMES, false, info);
+        check_same_as_per_frame(sound, FRAMES);
+    }
+}
+
+// frames per second when the data is read in 512 byte blocks like get_data_default does
+static double frames_per_second(SoundData &sound, bool bulk) {
+    uint8_t block[512];
+    volatile uint8_t sink = 0;
+    const int rounds = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int32_t pos = 0; pos < FRAMES * 4; pos += sizeof(block)) {
+            bulk ? sound.get2ChannelData(pos, sizeof(block), block) : per_frame_2channel_data(sound, pos, sizeof(block), block);
+            sink = sink + block[0];
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return (double) rounds * FRAMES / seconds;
+}
+
+static void benchmark(const char *name, SoundData &sound) {
+    double before = frames_per_second(sound, false);
+    double after = frames_per_second(sound, true);
+    char message[160];
+    snprintf(message, sizeof(message), "%s: per frame %.1f Mframes/s, bulk %.1f Mframes/s (x%.1f)", name, before / 1e6, after / 1e6, after / before);
+    TEST_MESSAGE(message);
+}
+
+void test_benchmark(void) {
+    TwoChannelSoundData two(stereo, FRAMES);
+    OneChannelSoundData one(mono16, FRAMES);
+    OneChannel8BitSoundData one8(mono8, FRAMES);
+    benchmark("TwoChannelSoundData", two);
+    benchmark("OneChannelSoundData", one);
+    benchmark("OneChannel8BitSoundData", one8);
+}
+
+int main(int argc, char **argv) {
+    fill_test_data();
+    UNITY_BEGIN();
+    RUN_TEST(test_two_channels_is_same_as_per_frame);
+    RUN_TEST(test_one_channel_is_same_as_per_frame);
+    RUN_TEST(test_one_channel_8bit_is_same_as_per_frame);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,235 @@
+// Host test of the gain, the saturation, the loop flag and the lock free start and stop of SoundMixer and its
+// benchmark: run with pio test -e native -v
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "SoundMixer.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static Frame full_scale[256];
+static Frame small[256];
+
+static void mix(SoundMixer &mixer, Frame *result, int32_t frames) {
+    TEST_ASSERT_EQUAL(frames * 4, mixer.get2ChannelData(0, frames * 4, (uint8_t*) result));
+}
+
+void test_gain_8_on_full_scale_saturates(void) {
+    TwoChannelSoundData data(full_scale, 256);
+    SoundMixer mixer;
+    TEST_ASSERT_EQUAL(0, mixer.play(&data, 8.0));
+    Frame result[256];
+    mix(mixer, result, 256);
+    for (int j = 0; j < 256; j++) {
+        TEST_ASSERT_EQUAL_INT16(j % 2 ? -32768 : 32767, result[j].channel1);
+        TEST_ASSERT_EQUAL_INT16(j % 2 ? 32767 : -32768, result[j].channel2);
+    }
+}
+
+void test_gain_is_limited_to_2(void) {
+    TwoChannelSoundData data(small, 256);
+    SoundMixer mixer;
+    int slot = mixer.play(&data, 8.0);
+    Frame result[4];
+    mix(mixer, result, 4);
+    TEST_ASSERT_EQUAL_INT16(2000, result[0].channel1);
+    TEST_ASSERT_EQUAL_INT16(-2000, result[0].channel2);
+
+    mixer.set_gain(slot, 0.5);
+    mix(mixer, result, 4);
+    TEST_ASSERT_EQUAL_INT16(500, result[0].channel1);
+    mixer.set_gain(slot, -1.0);
+    mix(mixer, result, 4);
+    TEST_ASSERT_EQUAL_INT16(0, result[0].channel1);
+    mixer.set_gain(slot, 1e12);
+    mix(mixer, result, 4);
+    TEST_ASSERT_EQUAL_INT16(2000, result[0].channel1);
+}
+
+void test_added_streams_saturate(void) {
+    TwoChannelSoundData first(full_scale, 256);
+    TwoChannelSoundData second(full_scale, 256);
+    SoundMixer mixer;
+    mixer.play(&first, 2.0);
+    mixer.play(&second, 8.0);
+    Frame result[256];
+    mix(mixer, result, 256);
+    for (int j = 0; j < 256; j++) {
+        TEST_ASSERT_EQUAL_INT16(j % 2 ? -32768 : 32767, result[j].channel1);
+        TEST_ASSERT_EQUAL_INT16(j % 2 ? 32767 : -32768, result[j].channel2);
+    }
+}
+
+void test_end_of_the_only_stream_is_silence(void) {
+    TwoChannelSoundData data(small, 100);
+    SoundMixer mixer;
+    int slot = mixer.play(&data, 1.0);
+    Frame result[256];
+    mix(mixer, result, 256);
+    TEST_ASSERT_EQUAL_INT16(1000, result[99].channel1);
+    TEST_ASSERT_EQUAL_INT16(0, result[100].channel1);
+    TEST_ASSERT_FALSE(mixer.is_playing(slot));
+}
+
+void test_loop_restarts_the_stream(void) {
+    Frame ramp[100];
+    for (int j = 0; j < 100; j++) {
+        ramp[j] = Frame(j, -j);
+    }
+    TwoChannelSoundData data(ramp, 100);
+    SoundMixer mixer;
+    int slot = mixer.play(&data, 1.0, true);
+    Frame result[256];
+    mix(mixer, result, 256);
+    for (int j = 0; j < 256; j++) {
+        TEST_ASSERT_EQUAL_INT16(j % 100, result[j].channel1);
+        TEST_ASSERT_EQUAL_INT16(-(j % 100), result[j].channel2);
+    }
+    TEST_ASSERT_TRUE(mixer.is_playing(slot));
+    // the position continues in the next callback
+    mix(mixer, result, 10);
+    TEST_ASSERT_EQUAL_INT16(56, result[0].channel1);
+}
+
+void test_stop_releases_the_slot_in_the_next_callback(void) {
+    TwoChannelSoundData first(small, 256, true);
+    TwoChannelSoundData second(small, 256, true);
+    SoundMixer mixer;
+    TEST_ASSERT_EQUAL(0, mixer.play(&first, 1.0, true));
+    TEST_ASSERT_EQUAL(1, mixer.play(&second, 0.5, true));
+    Frame result[4];
+    mix(mixer, result, 4);
+    TEST_ASSERT_EQUAL_INT16(1500, result[0].channel1);
+
+    mixer.stop(0);
+    mixer.stop(-1);
+    mixer.stop(A2DP_MIXER_STREAMS);
+    TEST_ASSERT_FALSE(mixer.is_playing(0));
+    TEST_ASSERT_TRUE(mixer.is_playing(1));
+    // the slot still belongs to the data callback
+    TEST_ASSERT_EQUAL(2, mixer.play(&first, 1.0, true));
+    mixer.stop(2);
+    mix(mixer, result, 4);
+    TEST_ASSERT_EQUAL_INT16(500, result[0].channel1);
+    TEST_ASSERT_EQUAL(0, mixer.play(&first, 2.0));
+
+    mixer.stop_all();
+    mix(mixer, result, 4);
+    TEST_ASSERT_EQUAL_INT16(0, result[0].channel1);
+    TEST_ASSERT_EQUAL_INT16(0, result[3].channel2);
+    for (int slot = 0; slot < A2DP_MIXER_STREAMS; slot++) {
+        TEST_ASSERT_EQUAL(slot, mixer.play(&first));
+    }
+    TEST_ASSERT_EQUAL(-1, mixer.play(&first));
+}
+
+// two tasks start and stop their streams while the data callback mixes: each mixed frame has to be the sum of
+// the streams which are playing, and stop_all() has to lead to silence
+void test_play_and_stop_from_other_tasks(void) {
+    static Frame ones[256], tens[256];
+    for (int j = 0; j < 256; j++) {
+        ones[j] = Frame(1, -1);
+        tens[j] = Frame(10, -10);
+    }
+    TwoChannelSoundData first(ones, 256, true);
+    TwoChannelSoundData second(tens, 256, true);
+    SoundMixer mixer;
+    std::atomic<bool> done{false};
+    std::atomic<int> starts{0};
+    // the tasks play and pause for different times, so that all combinations are mixed
+    auto control = [&](SoundData *data, int pause) {
+        while (!done) {
+            int slot = mixer.play(data, 1.0, true);
+            if (slot >= 0) {
+                starts++;
+                std::this_thread::yield();
+                mixer.stop(slot);
+            }
+            for (int j = 0; j < pause; j++) {
+                std::this_thread::yield();
+            }
+        }
+    };
+    std::thread a(control, &first, 1), b(control, &second, 3);
+
+    Frame result[128];
+    int mixed[4] = {};
+    for (int callback = 0; callback < 20000 || starts < 2000; callback++) {
+        std::this_thread::yield();
+        mix(mixer, result, 128);
+        for (int j = 0; j < 128; j++) {
+            int16_t value = result[j].channel1;
+            // each task has at most one playing slot: its stopped slots wait for the callback to release them
+            TEST_ASSERT_TRUE(value == 0 || value == 1 || value == 10 || value == 11);
+            TEST_ASSERT_EQUAL_INT16(-value, result[j].channel2);
+        }
+        // each stream is mixed in whole callbacks
+        TEST_ASSERT_EQUAL_INT16(result[0].channel1, result[127].channel1);
+        int value = result[0].channel1;
+        mixed[(value / 10 ? 2 : 0) + (value % 10 ? 1 : 0)]++;
+    }
+    done = true;
+    a.join();
+    b.join();
+
+    char message[120];
+    snprintf(message, sizeof(message), "%d starts, callbacks with none %d, first %d, second %d, both %d", starts.load(),
+        mixed[0], mixed[1], mixed[2], mixed[3]);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(starts > 0);
+    mixer.stop_all();
+    mix(mixer, result, 128);
+    mix(mixer, result, 128);
+    TEST_ASSERT_EQUAL_INT16(0, result[0].channel1);
+    for (int slot = 0; slot < A2DP_MIXER_STREAMS; slot++) {
+        TEST_ASSERT_FALSE(mixer.is_playing(slot));
+    }
+}
+
+void test_benchmark(void) {
+    static Frame music[4096];
+    for (int j = 0; j < 4096; j++) {
+        music[j] = Frame(j * 7 - 14000, 14000 - j * 5);
+    }
+    const int32_t frames = 10 * 44100;
+    for (int streams = 1; streams <= A2DP_MIXER_STREAMS; streams++) {
+        for (float gain : {1.0f, 0.5f}) {
+            TwoChannelSoundData data[A2DP_MIXER_STREAMS];
+            SoundMixer mixer;
+            for (int s = 0; s < streams; s++) {
+                data[s].setData(music, 4096);
+                mixer.play(&data[s], gain, true);
+            }
+            // a buffer of the A2DP data callback
+            uint8_t block[512];
+            auto start = std::chrono::steady_clock::now();
+            for (int32_t pos = 0; pos < frames * 4; pos += sizeof(block)) {
+                mixer.get2ChannelData(pos, sizeof(block), block);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            char message[120];
+            snprintf(message, sizeof(message), "%d streams, gain %.1f: %.2f us per buffer of 128 frames, %.0f us per second of audio",
+                streams, gain, seconds * 1e6 / (frames / 128), seconds * 1e6 / 10);
+            TEST_MESSAGE(message);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    for (int j = 0; j < 256; j++) {
+        full_scale[j] = j % 2 ? Frame(-32767, 32767) : Frame(32767, -32767);
+        small[j] = Frame(1000, -1000);
+    }
+    UNITY_BEGIN();
+    RUN_TEST(test_gain_8_on_full_scale_saturates);
+    RUN_TEST(test_gain_is_limited_to_2);
+    RUN_TEST(test_added_streams_saturate);
+    RUN_TEST(test_end_of_the_only_stream_is_silence);
+    RUN_TEST(test_loop_restarts_the_stream);
+    RUN_TEST(test_stop_releases_the_slot_in_the_next_callback);
+    RUN_TEST(test_play_and_stop_from_other_tasks);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,174 @@
+// Host test of StreamingSoundData with a regular file and a partition: run with pio test -e native
+#include <unity.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+#include "StreamingSoundData.h"
+
+static char path[] = "/tmp/streaming_sound_dataXXXXXX";
+static const int32_t FRAMES = 10000; // more than A2DP_STREAM_BUFFER_FRAMES: the refill task has to keep up
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// the sample of frame i and channel c in the test file
+static int16_t sample(int32_t i, int c) {
+    return (int16_t) (i * 3 + c * 1000);
+}
+
+static void write_file(int channels) {
+    std::vector<int16_t> samples;
+    for (int32_t i = 0; i < FRAMES; i++) {
+        for (int c = 0; c < channels; c++) {
+            samples.push_back(sample(i, c));
+        }
+    }
+    FILE *file = fopen(path, "wb");
+    fwrite(samples.data(), sizeof(int16_t), samples.size(), file);
+    fclose(file);
+}
+
+// reads frames in blocks like the A2DP callback, but gives the refill task the time to fill the cache
+static int32_t read_frames(StreamingSoundData &sound, int32_t pos, int32_t frames, Frame *data) {
+    int32_t result = 0;
+    while (result < frames) {
+        int32_t block = std::min(128, frames - result);
+        for (int wait = 0; wait < 1000 && sound.available() < block; wait++) {
+            usleep(1000);
+        }
+        int32_t len = sound.get2ChannelData((pos + result) * 4, block * 4, (uint8_t*) (data + result)) / 4;
+        if (len == 0) {
+            break;
+        }
+        result += len;
+    }
+    return result;
+}
+
+void test_stereo_file_is_read_completely(void) {
+    write_file(2);
+    FileSoundSource source(path);
+    StreamingSoundData sound(&source);
+    TEST_ASSERT_TRUE(sound.begin());
+
+    std::vector<Frame> frames(FRAMES + 100);
+    TEST_ASSERT_EQUAL(FRAMES, read_frames(sound, 0, FRAMES + 100, frames.data()));
+    for (int32_t i = 0; i < FRAMES; i++) {
+        TEST_ASSERT_EQUAL_INT16(sample(i, 0), frames[i].channel1);
+        TEST_ASSERT_EQUAL_INT16(sample(i, 1), frames[i].channel2);
+    }
+    TEST_ASSERT_EQUAL(0, sound.underruns());
+    TEST_ASSERT_EQUAL(0, sound.get2ChannelData(FRAMES * 4, 512, (uint8_t*) frames.data()));
+    sound.end();
+}
+
+void test_mono_file_is_expanded_to_the_channels(void) {
+    write_file(1);
+    for (ChannelInfo info : {Both, Left, Right}) {
+        FileSoundSource source(path);
+        StreamingSoundData sound(&source, false, 1, info);
+        TEST_ASSERT_TRUE(sound.begin());
+
+        std::vector<Frame> frames(FRAMES);
+        TEST_ASSERT_EQUAL(FRAMES, read_frames(sound, 0, FRAMES, frames.data()));
+        for (int32_t i = 0; i < FRAMES; i++) {
+            TEST_ASSERT_EQUAL_INT16(info == Right ? 0 : sample(i, 0), frames[i].channel1);
+            TEST_ASSERT_EQUAL_INT16(info == Left ? 0 : sample(i, 0), frames[i].channel2);
+        }
+        TEST_ASSERT_EQUAL(0, sound.underruns());
+    }
+}
+
+void test_loop_starts_again_after_the_end(void) {
+    write_file(2);
+    FileSoundSource source(path);
+    StreamingSoundData sound(&source, true);
+    TEST_ASSERT_TRUE(sound.begin());
+
+    std::vector<Frame> frames(FRAMES * 5 / 2);
+    TEST_ASSERT_EQUAL(frames.size(), read_frames(sound, 0, frames.size(), frames.data()));
+    for (int32_t i = 0; i < (int32_t) frames.size(); i++) {
+        TEST_ASSERT_EQUAL_INT16(sample(i % FRAMES, 0), frames[i].channel1);
+    }
+    TEST_ASSERT_EQUAL(0, sound.underruns());
+}
+
+void test_position_0_restarts_the_stream(void) {
+    write_file(2);
+    FileSoundSource source(path);
+    StreamingSoundData sound(&source);
+    TEST_ASSERT_TRUE(sound.begin());
+
+    std::vector<Frame> frames(FRAMES);
+    TEST_ASSERT_EQUAL(6000, read_frames(sound, 0, 6000, frames.data()));
+
+    // silence until the refill task has restarted from the beginning of the file, then the frames from there
+    Frame frame;
+    int32_t pos = 0;
+    do {
+        TEST_ASSERT_EQUAL(4, sound.get2ChannelData(pos * 4, 4, (uint8_t*) &frame));
+        pos++;
+        usleep(1000);
+    } while (frame.channel2 == 0 && pos < 1000);
+    TEST_ASSERT_EQUAL_INT16(sample(0, 1), frame.channel2);
+    TEST_ASSERT_EQUAL(FRAMES - 1, read_frames(sound, pos, FRAMES, frames.data()));
+    TEST_ASSERT_EQUAL_INT16(sample(1, 0), frames[0].channel1);
+    TEST_ASSERT_EQUAL_INT16(sample(FRAMES - 1, 0), frames[FRAMES - 2].channel1);
+}
+
+void test_consumer_which_does_not_wait_gets_silence(void) {
+    write_file(2);
+    FileSoundSource source(path);
+    StreamingSoundData sound(&source);
+    TEST_ASSERT_TRUE(sound.begin(512));
+
+    // the cache holds 512 frames: reading more at once can not be served without an underrun
+    std::vector<Frame> frames(1024, Frame(1));
+    TEST_ASSERT_EQUAL(1024 * 4, sound.get2ChannelData(0, 1024 * 4, (uint8_t*) frames.data()));
+    TEST_ASSERT_EQUAL(1, sound.underruns());
+    TEST_ASSERT_EQUAL_INT16(sample(511, 0), frames[511].channel1);
+    TEST_ASSERT_EQUAL_INT16(0, frames[512].channel1);
+    TEST_ASSERT_EQUAL_INT16(0, frames[1023].channel2);
+}
+
+void test_missing_file_fails(void) {
+    FileSoundSource source("/tmp/does/not/exist.raw");
+    StreamingSoundData sound(&source);
+    TEST_ASSERT_FALSE(sound.begin());
+    Frame frame;
+    TEST_ASSERT_EQUAL(0, sound.getData(0, frame));
+}
+
+void test_partition_is_read_up_to_the_given_size(void) {
+    uint8_t *memory = hostAddPartition("alarm", 2 * SPI_FLASH_SEC_SIZE);
+    for (int32_t i = 0; i < 2 * SPI_FLASH_SEC_SIZE / 4; i++) {
+        Frame frame(sample(i, 0), sample(i, 1));
+        memcpy(memory + i * 4, &frame, 4);
+    }
+    PartitionSoundSource source("alarm", 1000 * 4);
+    StreamingSoundData sound(&source);
+    TEST_ASSERT_TRUE(sound.begin());
+
+    std::vector<Frame> frames(2000);
+    TEST_ASSERT_EQUAL(1000, read_frames(sound, 0, 2000, frames.data()));
+    TEST_ASSERT_EQUAL_INT16(sample(999, 1), frames[999].channel2);
+
+    PartitionSoundSource missing("missing");
+    StreamingSoundData missing_sound(&missing);
+    TEST_ASSERT_FALSE(missing_sound.begin());
+}
+
+int main(int argc, char **argv) {
+    close(mkstemp(path));
+    UNITY_BEGIN();
+    RUN_TEST(test_stereo_file_is_read_completely);
+    RUN_TEST(test_mono_file_is_expanded_to_the_channels);
+    RUN_TEST(test_loop_starts_again_after_the_end);
+    RUN_TEST(test_position_0_restarts_the_stream);
+    RUN_TEST(test_consumer_which_does_not_wait_gets_silence);
+    RUN_TEST(test_missing_file_fails);
+    RUN_TEST(test_partition_is_read_up_to_the_given_size);
+    int result = UNITY_END();
+    unlink(path);
+    return result;
+}
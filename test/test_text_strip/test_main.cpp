@@ -0,0 +1,185 @@
+// Host test of TextStrip and printText() against printing the text with the matrix at every scroll position, as
+// printText() did before the strip, and benchmark of both: run with pio test -e native -v
+#include <unity.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+
+#define FRAME_PIPELINE false
+
+#include "wifi_spots.h"
+#include "images.h"
+#include "ledmap.h"
+#include "effects.h"
+#include "animation.h"
+#include "settings.h"
+#include "scheduler.h"
+#include "ledoutput.h"
+#include "framebuffer.h"
+#include "textstrip.h"
+#include "screens.h"
+
+void presentFrame() {
+  frameBuffer.present();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const size_t frameSize = MATRIX_WIDTH * MATRIX_HEIGHT * 3;
+
+static Adafruit_NeoMatrix reference(MATRIX_WIDTH, MATRIX_HEIGHT, PIN, MATRIX_LAYOUT, MATRIX_PIXEL_TYPE);
+
+static std::vector<uint8_t> pixelsOf(Adafruit_NeoMatrix &m) {
+    return std::vector<uint8_t>(m.getPixels(), m.getPixels() + frameSize);
+}
+
+// printText() before TextStrip: the whole text is printed for every frame
+static void legacyPrintText(Adafruit_NeoMatrix &m, const char *text, uint16_t desiredColor, unsigned long now) {
+    int textLength = strlen(text);
+
+    m.setTextColor(desiredColor);
+    m.fillScreen(0);
+
+    if (textLength < 6) {
+        m.setCursor(2, 0);
+    } else {
+        int scrollLength = 2 + 6 * textLength;
+        m.setCursor(2 - (int)((now / scrollTimeout) % (scrollLength + 1)), 0);
+    }
+    m.print(text);
+}
+
+// every scroll position and the first ones of the next round
+static void assertLikeLegacy(const char *text, uint16_t color) {
+    int positions = 6 * strlen(text) + 3 + 5;
+    for (int position = 0; position < positions; position++) {
+        // any time within the step of the position
+        unsigned long now = position * scrollTimeout + position % scrollTimeout;
+        legacyPrintText(reference, text, color, now);
+        printText(text, color, now);
+        char message[80];
+        snprintf(message, sizeof(message), "\"%.40s\" at %d", text, position);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize, message);
+    }
+}
+
+static std::string longText(int length) {
+    std::string text;
+    for (int i = 0; i < length; i++) {
+        text += (char)(' ' + (i * 7) % 95);
+    }
+    return text;
+}
+
+void test_static_texts_are_like_legacy(void) {
+    for (const char *text : { "12:34", "rain", "a", "music" }) {
+        assertLikeLegacy(text, colors[0]);
+    }
+}
+
+void test_scrolling_texts_are_like_legacy(void) {
+    // 6 characters is the shortest text which scrolls, 20 the longest message
+    for (const char *text : { "hello!", "hello world", "love you love you :)", "0123456789abcdefghij" }) {
+        assertLikeLegacy(text, colors[3]);
+    }
+    // characters outside the font are drawn as a box by both
+    assertLikeLegacy("caf\xc3\xa9 \x7f\x01 ok", colors[5]);
+}
+
+void test_long_texts_are_like_legacy(void) {
+    assertLikeLegacy(longText(200).c_str(), colors[1]);
+    assertLikeLegacy(longText(1000).c_str(), colors[2]);
+}
+
+void test_empty_text_clears_the_matrix(void) {
+    ledMap.fill(0xFFFF);
+    assertLikeLegacy("", colors[0]);
+    TEST_ASSERT_EQUAL(0, textStrip.width());
+    for (uint8_t value : pixelsOf(matrix)) {
+        TEST_ASSERT_EQUAL_UINT8(0, value);
+    }
+}
+
+void test_set_text_renders_again_when_the_text_changes(void) {
+    TextStrip strip;
+    strip.setText("hello world");
+    TEST_ASSERT_EQUAL(66, strip.width());
+    strip.setText("hi");
+    TEST_ASSERT_EQUAL(12, strip.width());
+    strip.draw(2, colors[0]);
+    legacyPrintText(reference, "hi", colors[0], 0);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize);
+
+    // the screens pass the same buffer with a new text: the content decides, not the pointer
+    char text[] = "12:34";
+    strip.setText(text);
+    strcpy(text, "12:35");
+    strip.setText(text);
+    strip.draw(2, colors[0]);
+    legacyPrintText(reference, "12:35", colors[0], 0);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize);
+
+    // and the color is not part of the strip
+    strip.setText("12:35");
+    strip.draw(2, colors[4]);
+    legacyPrintText(reference, "12:35", colors[4], 0);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(pixelsOf(reference).data(), pixelsOf(matrix).data(), frameSize);
+}
+
+// us per frame over all scroll positions of the text
+template <typename Print> static double usPerFrame(const std::string &text, Print print) {
+    int positions = 6 * text.size() + 3;
+    int rounds = max(1, 20000 / positions);
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (int position = 0; position < positions; position++) {
+            print(text.c_str(), position * scrollTimeout);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e6 / rounds / positions;
+}
+
+void test_benchmark(void) {
+    for (int length : { 20, 200 }) {
+        std::string text = longText(length);
+        double legacy = usPerFrame(text, [](const char *t, unsigned long now) {
+            legacyPrintText(matrix, t, colors[0], now);
+        });
+        double strip = usPerFrame(text, [](const char *t, unsigned long now) {
+            printText(t, colors[0], now);
+        });
+        // the first frame of a new text renders the strip
+        auto start = std::chrono::steady_clock::now();
+        TextStrip fresh;
+        fresh.setText(text.c_str());
+        double render = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1e6;
+
+        char message[120];
+        snprintf(message, sizeof(message), "%d characters: fillScreen + print %.2f us, strip %.2f us per frame, "
+            "rendering %.1f us", length, legacy, strip, render);
+        TEST_MESSAGE(message);
+    }
+}
+
+int main(int argc, char **argv) {
+    Serial.isCaptured = true;
+    matrix.begin();
+    matrix.setTextWrap(false);
+    matrix.setBrightness(BRIGHTNESS_DAY);
+    reference.begin();
+    reference.setTextWrap(false);
+    reference.setBrightness(BRIGHTNESS_DAY);
+    ledMap.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_static_texts_are_like_legacy);
+    RUN_TEST(test_scrolling_texts_are_like_legacy);
+    RUN_TEST(test_long_texts_are_like_legacy);
+    RUN_TEST(test_empty_text_clears_the_matrix);
+    RUN_TEST(test_set_text_renders_again_when_the_text_changes);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
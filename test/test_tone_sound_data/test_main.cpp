@@ -0,0 +1,182 @@
+// Host test (frequency, envelope, melody) and benchmark of ToneSoundData: run with pio test -e native -v
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <vector>
+#include "ToneSoundData.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const int32_t RATE = 44100;
+
+static std::vector<int16_t> render(ToneSoundData &tone, int32_t frames) {
+    std::vector<Frame> data(frames);
+    int32_t len = tone.get2ChannelData(0, frames * 4, (uint8_t*) data.data()) / 4;
+    std::vector<int16_t> result;
+    for (int32_t i = 0; i < len; i++) {
+        result.push_back(data[i].channel1);
+        TEST_ASSERT_EQUAL_INT16(data[i].channel1, data[i].channel2);
+    }
+    return result;
+}
+
+// Hz from the rising zero crossings in [start, end), interpolated between the samples
+static double frequency(const std::vector<int16_t> &samples, int32_t start, int32_t end) {
+    double first = -1, last = -1;
+    int32_t crossings = 0;
+    for (int32_t i = start + 1; i < end; i++) {
+        if (samples[i - 1] < 0 && samples[i] >= 0) {
+            double t = i - 1 + (double) -samples[i - 1] / (samples[i] - samples[i - 1]);
+            if (first < 0) {
+                first = t;
+            } else {
+                crossings++;
+            }
+            last = t;
+        }
+    }
+    return crossings == 0 ? 0 : crossings * RATE / (last - first);
+}
+
+// the largest magnitude in the ms which starts at ms
+static int32_t peak(const std::vector<int16_t> &samples, double ms) {
+    int32_t result = 0;
+    for (int32_t i = ms * RATE / 1000; i < (ms + 1) * RATE / 1000 && i < (int32_t) samples.size(); i++) {
+        result = std::max(result, abs(samples[i]));
+    }
+    return result;
+}
+
+void test_frequency_accuracy(void) {
+    for (uint16_t hz : {55, 440, 1000, 3520, 12000}) {
+        // the harmonics of a high square wave alias: its zero crossings jitter
+        for (ToneWaveform waveform : {ToneSine, ToneSquare}) {
+            if (waveform == ToneSquare && hz > 4000) {
+                continue;
+            }
+            ToneSoundData tone;
+            tone.note_on(0, hz, waveform);
+            std::vector<int16_t> samples = render(tone, 2 * RATE);
+            double measured = frequency(samples, RATE / 10, samples.size());
+            char message[80];
+            snprintf(message, sizeof(message), "%u Hz %s: %.4f Hz", hz, waveform == ToneSine ? "sine" : "square", measured);
+            TEST_ASSERT_TRUE_MESSAGE(fabs(measured - hz) < 0.01, message);
+        }
+    }
+}
+
+void test_sine_is_clean(void) {
+    ToneSoundData tone;
+    tone.note_on(0, 1000, ToneSine, 1.0);
+    std::vector<int16_t> samples = render(tone, RATE);
+    // after the envelope (5 ms attack, 50 ms decay) the sustain level of 70% stays: 0.9 s are 900 whole periods,
+    // so the projections onto sin and cos give the best fitting sine
+    int32_t start = RATE / 10, len = RATE - start;
+    double a = 0, b = 0;
+    for (int32_t i = start; i < RATE; i++) {
+        a += samples[i] * sin(2 * M_PI * 1000.0 * i / RATE) * 2 / len;
+        b += samples[i] * cos(2 * M_PI * 1000.0 * i / RATE) * 2 / len;
+    }
+    double signal = 0, noise = 0;
+    for (int32_t i = start; i < RATE; i++) {
+        double fit = a * sin(2 * M_PI * 1000.0 * i / RATE) + b * cos(2 * M_PI * 1000.0 * i / RATE);
+        signal += fit * fit;
+        noise += (samples[i] - fit) * (samples[i] - fit);
+    }
+    double snr = 10 * log10(signal / noise);
+    int amplitude = lround(sqrt(a * a + b * b));
+    char message[80];
+    snprintf(message, sizeof(message), "1000 Hz sine: amplitude %d, THD+N %.1f dB", amplitude, -snr);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_INT_WITHIN(400, 32767 * 7 / 10, amplitude);
+    TEST_ASSERT_TRUE(snr > 60);
+}
+
+void test_envelope(void) {
+    ToneSoundData tone;
+    tone.set_envelope(0, {10, 20, 50, 30});
+    tone.note_on(0, 1000, ToneSine, 1.0);
+    std::vector<int16_t> samples = render(tone, RATE / 10);
+    // attack to full scale in 10 ms, decay to 50% in another 20 ms, then sustain
+    TEST_ASSERT_INT_WITHIN(1000, 32767 / 2, peak(samples, 4.5));
+    TEST_ASSERT_INT_WITHIN(500, 32767, peak(samples, 9.5));
+    TEST_ASSERT_INT_WITHIN(1000, 32767 * 3 / 4, peak(samples, 19.5));
+    TEST_ASSERT_INT_WITHIN(500, 32767 / 2, peak(samples, 31));
+    TEST_ASSERT_INT_WITHIN(500, 32767 / 2, peak(samples, 99));
+
+    // release to silence in 30 ms: then the data ends
+    tone.note_off(0);
+    samples = render(tone, RATE / 10);
+    TEST_ASSERT_INT_WITHIN(500, 32767 / 4, peak(samples, 15));
+    TEST_ASSERT_EQUAL(0, peak(samples, 31));
+    TEST_ASSERT_FALSE(tone.is_active());
+    TEST_ASSERT_EQUAL(0, render(tone, 128).size());
+}
+
+void test_melody(void) {
+    static const tone_note_t melody[] = { {440, 200}, {0, 100}, {880, 200} };
+    ToneSoundData tone;
+    tone.play_sequence(1, melody, 3);
+    std::vector<int16_t> samples;
+    while (tone.is_active() && samples.size() < (size_t) RATE) {
+        std::vector<int16_t> block = render(tone, 128);
+        samples.insert(samples.end(), block.begin(), block.end());
+    }
+    TEST_ASSERT_TRUE(fabs(frequency(samples, RATE * 20 / 1000, RATE * 150 / 1000) - 440) < 0.5);
+    TEST_ASSERT_TRUE(fabs(frequency(samples, RATE * 320 / 1000, RATE * 450 / 1000) - 880) < 0.5);
+    // a note is released at 7/8 of its duration (175 ms) and the release takes 50 ms: the data ends
+    // with the release of the last note, in a whole block
+    TEST_ASSERT_EQUAL(0, peak(samples, 250));
+    TEST_ASSERT_EQUAL(0, peak(samples, 299));
+    TEST_ASSERT_TRUE(samples.size() >= RATE * 525 / 1000 && samples.size() <= RATE * 525 / 1000 + 128);
+}
+
+void test_voices_are_added(void) {
+    ToneSoundData one;
+    one.note_on(0, 1000, ToneSine, 0.25);
+    ToneSoundData two;
+    two.note_on(0, 1000, ToneSine, 0.25);
+    two.note_on(3, 1000, ToneSine, 0.25);
+    std::vector<int16_t> a = render(one, RATE / 10);
+    std::vector<int16_t> b = render(two, RATE / 10);
+    for (int32_t i = 0; i < RATE / 10; i++) {
+        TEST_ASSERT_INT_WITHIN(2, 2 * a[i], b[i]);
+    }
+}
+
+void test_benchmark(void) {
+    for (int voices = 1; voices <= A2DP_TONE_VOICES; voices++) {
+        for (bool sustained : {true, false}) {
+            ToneSoundData tone;
+            for (int v = 0; v < voices; v++) {
+                // a long attack keeps the envelope busy for the whole measurement
+                tone.set_envelope(v, {(uint16_t) (sustained ? 1 : 60000), 1, 100, 50});
+                tone.note_on(v, 220 * (v + 1), ToneSaw, 0.2);
+            }
+            uint8_t block[512];
+            render(tone, RATE / 100);
+            const int32_t frames = 10 * RATE;
+            auto start = std::chrono::steady_clock::now();
+            for (int32_t pos = 0; pos < frames * 4; pos += sizeof(block)) {
+                tone.get2ChannelData(pos, sizeof(block), block);
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            char message[120];
+            snprintf(message, sizeof(message), "%d voices, %s: %.0f us per second of audio, %.1f ns per voice and frame",
+                voices, sustained ? "sustain" : "attack", seconds * 1e6 / 10, seconds * 1e9 / frames / voices);
+            TEST_MESSAGE(message);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_frequency_accuracy);
+    RUN_TEST(test_sine_is_clean);
+    RUN_TEST(test_envelope);
+    RUN_TEST(test_melody);
+    RUN_TEST(test_voices_are_added);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}